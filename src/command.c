@@ -61,6 +61,28 @@ consvar_t *CV_FindVar(const char *name);
 static const char *CV_StringValue(const char *var_name);
 static consvar_t *consvar_vars; // list of registered console variables
 
+#define CVARHASHSIZE 1024 // power of two
+
+typedef struct cvarhash_s
+{
+	consvar_t *cvar;
+	UINT16 netid; // in consvar_netids, since a variable can have more than one
+	struct cvarhash_s *next;
+} cvarhash_t;
+
+static cvarhash_t *consvar_names[CVARHASHSIZE]; // registered variables by name, case-insensitively
+static cvarhash_t *consvar_netids[CVARHASHSIZE]; // net variables by netid, including hidden ones
+
+// Other netids some variables are known by, from other builds
+static const struct
+{
+	const char *name;
+	UINT16 netid;
+} cv_netidaliases[] = {
+	{"karteliminatelast", 44542},
+	{NULL, 0}
+};
+
 static char com_token[1024];
 static char *COM_Parse(char *data);
 
@@ -1144,6 +1166,16 @@ void VS_Print(vsbuf_t *buf, const char *data)
 
 static const char *cv_null_string = "";
 
+// FNV-1a of the lowercase name, folded to a consvar_names index.
+static UINT32 CV_HashName(const char *name)
+{
+	UINT32 hash = 2166136261u;
+
+	while (*name)
+		hash = (hash ^ (UINT8)tolower(*name++)) * 16777619u;
+	return (hash ^ (hash >> 16)) & (CVARHASHSIZE - 1);
+}
+
 /** Searches if a variable has been registered.
   *
   * \param name Variable to search for.
@@ -1152,11 +1184,11 @@ static const char *cv_null_string = "";
   */
 consvar_t *CV_FindVar(const char *name)
 {
-	consvar_t *cvar;
+	cvarhash_t *entry;
 
-	for (cvar = consvar_vars; cvar; cvar = cvar->next)
-		if (!stricmp(name,cvar->name))
-			return cvar;
+	for (entry = consvar_names[CV_HashName(name)]; entry; entry = entry->next)
+		if (!stricmp(name,entry->cvar->name))
+			return entry->cvar;
 
 	return NULL;
 }
@@ -1190,18 +1222,37 @@ static inline UINT16 CV_ComputeNetid(const char *s)
   */
 static consvar_t *CV_FindNetVar(UINT16 netid)
 {
-	consvar_t *cvar;
-
-	for (cvar = consvar_vars; cvar; cvar = cvar->next)
-		if (cvar->netid == netid)
-			return cvar;
+	cvarhash_t *entry;
 
-	if (netid == 44542) // ouch this hack
-		return &cv_karteliminatelast;
+	for (entry = consvar_netids[netid & (CVARHASHSIZE - 1)]; entry; entry = entry->next)
+		if (entry->netid == netid)
+			return entry->cvar;
 
 	return NULL;
 }
 
+/** Makes a net variable findable by a netid,
+  * unless another one already has it.
+  *
+  * \param variable The variable.
+  * \param netid The identifier number to find it by.
+  * \sa CV_FindNetVar
+  */
+static void CV_AddNetid(consvar_t *variable, UINT16 netid)
+{
+	cvarhash_t *entry;
+	const consvar_t *netvar = CV_FindNetVar(netid);
+
+	if (netvar)
+		I_Error("Variables %s and %s have same netid\n", variable->name, netvar->name);
+
+	entry = Z_Malloc(sizeof (*entry), PU_STATIC, NULL);
+	entry->netid = netid;
+	entry->cvar = variable;
+	entry->next = consvar_netids[netid & (CVARHASHSIZE - 1)];
+	consvar_netids[netid & (CVARHASHSIZE - 1)] = entry;
+}
+
 static void Setvalue(consvar_t *var, const char *valstr, boolean stealth);
 
 /** Registers a variable for later use from the console.
@@ -1227,18 +1278,28 @@ void CV_RegisterVar(consvar_t *variable)
 	// check net variables
 	if (variable->flags & CV_NETVAR)
 	{
-		const consvar_t *netvar;
+		INT32 i;
+
 		variable->netid = CV_ComputeNetid(variable->name);
-		netvar = CV_FindNetVar(variable->netid);
-		if (netvar)
-			I_Error("Variables %s and %s have same netid\n", variable->name, netvar->name);
+		CV_AddNetid(variable, variable->netid);
+
+		for (i = 0; cv_netidaliases[i].name; i++)
+			if (!stricmp(variable->name, cv_netidaliases[i].name))
+				CV_AddNetid(variable, cv_netidaliases[i].netid);
 	}
 
 	// link the variable in
 	if (!(variable->flags & CV_HIDEN))
 	{
+		UINT32 hash = CV_HashName(variable->name);
+		cvarhash_t *entry = Z_Malloc(sizeof (*entry), PU_STATIC, NULL);
+
 		variable->next = consvar_vars;
 		consvar_vars = variable;
+		entry->cvar = variable;
+		entry->netid = 0;
+		entry->next = consvar_names[hash];
+		consvar_names[hash] = entry;
 	}
 	variable->string = variable->zstring = NULL;
 	variable->changed = 0; // new variable has not been modified by the user
@@ -44,6 +44,9 @@
 #include "m_argv.h"
 #include "p_setup.h"
 #include "lzf.h"
+#include "m_compress.h"
+#include "m_delta.h"
+#include "md5.h"
 #include "lua_script.h"
 #include "lua_hook.h"
 #include "k_kart.h"
@@ -96,6 +99,7 @@ static boolean sendingsavegame[MAXNETNODES]; // Are we sending the savegame?
 static boolean resendingsavegame[MAXNETNODES]; // Are we resending the savegame?
 static tic_t savegameresendcooldown[MAXNETNODES]; // How long before we can resend again?
 static tic_t freezetimeout[MAXNETNODES]; // Until when can this node freeze the server before getting a timeout?
+static UINT8 nodecodecs[MAXNETNODES]; // Compression codecs the node can decode, besides LZF
 
 UINT16 pingmeasurecount = 1;
 UINT32 realpingtable[MAXPLAYERS]; //the base table of ping where an average will be sent to everyone.
@@ -846,6 +850,7 @@ static boolean CL_SendJoin(void)
 	netbuffer->u.clientcfg.subversion = SUBVERSION;
 	strncpy(netbuffer->u.clientcfg.application, SRB2APPLICATION,
 			sizeof netbuffer->u.clientcfg.application);
+	netbuffer->u.clientcfg.codecs = M_SupportedCodecs();
 
 	return HSendPacket(servernode, false, 0, sizeof (clientconfig_pak));
 }
@@ -1155,6 +1160,53 @@ static boolean SV_SendServerConfig(INT32 node)
 
 #ifdef JOININGAME
 #define SAVEGAMESIZE (768*1024)
+#define SAVEGAME_DELTA 0x80000000 // Set in a sent savegame's length word if it's changes to the last one
+#define SAVEGAME_CODEC 0x40000000 // Set if the length word is followed by a codec_t byte, otherwise it's LZF
+
+// The last game state sent to each node, uncompressed.
+// If the node confirms it still has it, the next one is sent as a delta.
+static UINT8 *savebaseline[MAXNETNODES];
+static size_t savebaselinelength[MAXNETNODES];
+static UINT8 savebaselinemd5[MAXNETNODES][16];
+
+// The last game state received from the server, uncompressed.
+static UINT8 *cl_savebaseline;
+static size_t cl_savebaselinelength;
+static UINT8 cl_savebaselinemd5[16];
+
+static void SV_FreeSaveBaseline(INT32 node)
+{
+	free(savebaseline[node]);
+	savebaseline[node] = NULL;
+	savebaselinelength[node] = 0;
+}
+
+static void CL_FreeSaveBaseline(void)
+{
+	free(cl_savebaseline);
+	cl_savebaseline = NULL;
+	cl_savebaselinelength = 0;
+}
+
+// Copies a game state as the baseline for the next delta,
+// or drops the old baseline if there isn't enough memory.
+static void SetSaveBaseline(UINT8 **baseline, size_t *baselinelength, UINT8 *md5sum, const UINT8 *state, size_t length)
+{
+	UINT8 *copy = realloc(*baseline, length);
+
+	if (!copy)
+	{
+		free(*baseline);
+		*baseline = NULL;
+		*baselinelength = 0;
+		return;
+	}
+
+	M_Memcpy(copy, state, length);
+	md5_buffer((const char *)copy, length, md5sum);
+	*baseline = copy;
+	*baselinelength = length;
+}
 
 static boolean SV_ResendingSavegameToAnyone(void)
 {
@@ -1166,12 +1218,26 @@ static boolean SV_ResendingSavegameToAnyone(void)
 	return false;
 }
 
+// The codec the server wants, if the node has it.
+static codec_t SV_GamestateCodec(INT32 node)
+{
+	if (nodecodecs[node] & CODECBIT(cv_gamestatecodec.value))
+		return cv_gamestatecodec.value;
+	return CODEC_LZF;
+}
+
 static void SV_SendSaveGame(INT32 node, boolean resending)
 {
 	size_t length, compressedlen;
 	savebuffer_t save;
 	UINT8 *compressedsave;
 	UINT8 *buffertosend;
+	freemethod_t freemethod;
+	UINT8 *deltasave = NULL;
+	size_t deltalen = 0;
+	UINT32 delta = 0;
+	codec_t codec = SV_GamestateCodec(node);
+	size_t headerlength = sizeof(UINT32) + (codec != CODEC_LZF); // length word, codec byte
 
 	// first save it in a malloced buffer
 	save.buffer = (UINT8 *)malloc(SAVEGAMESIZE);
@@ -1194,6 +1260,36 @@ static void SV_SendSaveGame(INT32 node, boolean resending)
 		I_Error("Savegame buffer overrun");
 	}
 
+	// If the node still has the last game state we sent it,
+	// only send what changed since then.
+	if (savebaseline[node])
+	{
+		deltasave = malloc(length);
+		if (deltasave)
+			deltalen = M_DeltaEncode(savebaseline[node], savebaselinelength[node],
+				save.buffer + sizeof(UINT32), length - sizeof(UINT32),
+				deltasave + sizeof(UINT32), length - sizeof(UINT32) - 1);
+		if (!deltalen)
+		{
+			free(deltasave);
+			deltasave = NULL;
+		}
+	}
+
+	// This is what the node will have after loading it.
+	SetSaveBaseline(&savebaseline[node], &savebaselinelength[node], savebaselinemd5[node],
+		save.buffer + sizeof(UINT32), length - sizeof(UINT32));
+
+	if (deltasave)
+	{
+		CONS_Debug(DBG_NETPLAY, "Sending game state as %s bytes of changes instead of %s bytes\n",
+			sizeu1(deltalen), sizeu2(length - sizeof(UINT32)));
+		free(save.buffer);
+		save.buffer = deltasave;
+		length = deltalen + sizeof(UINT32);
+		delta = SAVEGAME_DELTA;
+	}
+
 	// Allocate space for compressed save: one byte fewer than for the
 	// uncompressed data to ensure that the compression is worthwhile.
 	compressedsave = Z_Malloc(length - 1, PU_STATIC, NULL);
@@ -1204,16 +1300,23 @@ static void SV_SendSaveGame(INT32 node, boolean resending)
 	}
 
 	// Attempt to compress it.
-	if ((compressedlen = lzf_compress(save.buffer + sizeof(UINT32), length - sizeof(UINT32), compressedsave + sizeof(UINT32), length - sizeof(UINT32) - 1)))
+	if ((compressedlen = M_Compress(codec, save.buffer + sizeof(UINT32), length - sizeof(UINT32), compressedsave + headerlength, length - headerlength - 1)))
 	{
 		// Compressing succeeded; send compressed data
 
 		free(save.buffer);
 
-		// State that we're compressed.
+		// State that we're compressed, and how.
 		buffertosend = compressedsave;
-		WRITEUINT32(compressedsave, length - sizeof(UINT32));
-		length = compressedlen + sizeof(UINT32);
+		if (codec == CODEC_LZF)
+			WRITEUINT32(compressedsave, (length - sizeof(UINT32)) | delta);
+		else
+		{
+			WRITEUINT32(compressedsave, (length - sizeof(UINT32)) | delta | SAVEGAME_CODEC);
+			WRITEUINT8(compressedsave, codec);
+		}
+		length = compressedlen + headerlength;
+		freemethod = SF_Z_RAM;
 	}
 	else
 	{
@@ -1222,10 +1325,11 @@ static void SV_SendSaveGame(INT32 node, boolean resending)
 
 		// State that we're not compressed
 		buffertosend = save.buffer;
-		WRITEUINT32(save.buffer, 0);
+		WRITEUINT32(save.buffer, delta);
+		freemethod = SF_RAM;
 	}
 
-	SV_SendRam(node, buffertosend, length, SF_Z_RAM, 0);
+	SV_SendRam(node, buffertosend, length, freemethod, 0);
 	save.p = NULL;
 
 	// Remember when we started sending the savegame so we can handle timeouts
@@ -1256,7 +1360,7 @@ static void SV_SavedGame(void)
 		return;
 	}
 
-	P_SaveNetGame(&save);
+	P_SaveNetGame(&save, false);
 
 	length = save.p - save.buffer;
 	if (length > SAVEGAMESIZE)
@@ -1282,6 +1386,8 @@ static void CL_LoadReceivedSavegame(boolean reloading)
 {
 	savebuffer_t save;
 	size_t length, decompressedlen;
+	UINT32 header;
+	codec_t codec = CODEC_LZF;
 	char tmpsave[264];
 
 	sprintf(tmpsave, "%s" PATHSEP TMPSAVENAME, srb2home);
@@ -1289,7 +1395,7 @@ static void CL_LoadReceivedSavegame(boolean reloading)
 	length = FIL_ReadFile(tmpsave, &save.buffer);
 
 	CONS_Printf(M_GetText("Loading savegame length %s\n"), sizeu1(length));
-	if (!length)
+	if (length < sizeof(UINT32))
 	{
 		I_Error("Can't read savegame sent");
 		return;
@@ -1298,16 +1404,51 @@ static void CL_LoadReceivedSavegame(boolean reloading)
 	save.p = save.buffer;
 
 	// Decompress saved game if necessary.
-	decompressedlen = READUINT32(save.p);
+	header = READUINT32(save.p);
+	decompressedlen = header & ~(SAVEGAME_DELTA|SAVEGAME_CODEC);
+	length -= sizeof(UINT32);
+
+	if (header & SAVEGAME_CODEC)
+	{
+		if (!length)
+			I_Error("Can't read savegame sent");
+		codec = READUINT8(save.p);
+		length--;
+	}
 
 	if (decompressedlen > 0)
 	{
 		UINT8 *decompressedbuffer = Z_Malloc(decompressedlen, PU_STATIC, NULL);
-		lzf_decompress(save.p, length - sizeof(UINT32), decompressedbuffer, decompressedlen);
+		if (M_Decompress(codec, save.p, length, decompressedbuffer, decompressedlen) != decompressedlen)
+			I_Error("Can't decompress %s savegame sent", M_CodecName(codec));
 		Z_Free(save.buffer);
 		save.p = save.buffer = decompressedbuffer;
+		length = decompressedlen;
 	}
 
+	// Apply the changes to the last game state we got.
+	if (header & SAVEGAME_DELTA)
+	{
+		size_t statelen = M_DeltaDecodedLength(save.p, length);
+		UINT8 *state;
+
+		if (!cl_savebaseline || !statelen)
+			I_Error("Received game state changes without the game state they apply to");
+
+		state = Z_Malloc(statelen, PU_STATIC, NULL);
+		if (M_DeltaDecode(cl_savebaseline, cl_savebaselinelength, save.p, length, state, statelen) != statelen)
+			I_Error("Received corrupt game state changes");
+
+		CONS_Printf(M_GetText("Applied %s bytes of changes, game state length %s\n"), sizeu1(length), sizeu2(statelen));
+		Z_Free(save.buffer);
+		save.p = save.buffer = state;
+		length = statelen;
+	}
+
+	// Keep it so the server can send only what changed next time.
+	SetSaveBaseline(&cl_savebaseline, &cl_savebaselinelength, cl_savebaselinemd5, save.p, length);
+	save.end = save.p + length;
+
 	paused = false;
 	demo.playback = false;
 	demo.title = false;
@@ -1378,6 +1519,49 @@ static void CL_ReloadReceivedSavegame(void)
 
 	CONS_Printf(M_GetText("Game state reloaded\n"));
 }
+
+// Compares the gamestate codecs on a savegame file, such as
+// the ones SV_SavedGame writes, or on the current game state.
+static void Command_BenchGamestateCodecs(void)
+{
+	savebuffer_t save;
+	size_t length;
+
+	if (COM_Argc() > 1)
+	{
+		length = FIL_ReadFile(COM_Argv(1), &save.buffer);
+		if (!length)
+		{
+			CONS_Printf(M_GetText("Couldn't read %s\n"), COM_Argv(1));
+			return;
+		}
+		M_BenchmarkCodecs(save.buffer, length);
+		Z_Free(save.buffer);
+		return;
+	}
+
+	if (gamestate != GS_LEVEL)
+	{
+		CONS_Printf(M_GetText("benchgamestatecodecs [savegame]: compare gamestate compression codecs, on the current game if no file is given\n"));
+		return;
+	}
+
+	save.p = save.buffer = (UINT8 *)malloc(SAVEGAMESIZE);
+	if (!save.p)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
+		return;
+	}
+
+	P_SaveNetGame(&save, false);
+
+	length = save.p - save.buffer;
+	if (length > SAVEGAMESIZE)
+		I_Error("Savegame buffer overrun");
+
+	M_BenchmarkCodecs(save.buffer, length);
+	free(save.buffer);
+}
 #endif
 
 #ifndef NONET
@@ -2720,6 +2904,9 @@ void CL_Reset(void)
 	}
 	D_CloseConnection(); // netgame = false
 	multiplayer = false;
+#ifdef JOININGAME
+	CL_FreeSaveBaseline();
+#endif
 	servernode = 0;
 	server = true;
 	doomcom->numnodes = 1;
@@ -3468,6 +3655,20 @@ consvar_t cv_resynchcooldown = {"gamestatecooldown", "5", CV_SAVE, resynchcooldo
 
 consvar_t cv_blamecfail = {"blamecfail", "Off", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL	};
 
+// Codec for game states sent to clients that have it, everyone else gets LZF
+static CV_PossibleValue_t gamestatecodec_cons_t[] = {
+	{CODEC_LZF, "LZF"},
+	{CODEC_LZ4, "LZ4"},
+#ifdef HAVE_ZLIB
+	{CODEC_DEFLATE, "Deflate"},
+#endif
+	{0, NULL}};
+#ifdef HAVE_ZLIB
+consvar_t cv_gamestatecodec = {"gamestatecodec", "Deflate", CV_SAVE, gamestatecodec_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+#else
+consvar_t cv_gamestatecodec = {"gamestatecodec", "LZ4", CV_SAVE, gamestatecodec_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+#endif
+
 // max file size to send to a player (in kilobytes)
 static CV_PossibleValue_t maxsend_cons_t[] = {{0, "MIN"}, {51200, "MAX"}, {0, NULL}};
 consvar_t cv_maxsend = {"maxsend", "MAX", CV_SAVE, maxsend_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
@@ -3520,6 +3721,7 @@ void D_ClientServerInit(void)
 	COM_AddCommand("resendgamestate", Command_ResendGamestate);
 	COM_AddCommand("listplayers", Command_Listplayers);
 	COM_AddCommand("packetstat", Command_Packetstat);
+	COM_AddCommand("benchgamestatecodecs", Command_BenchGamestateCodecs);
 #ifdef HAVE_CURL
 	COM_AddCommand("set_http_login", Command_set_http_login);
 	COM_AddCommand("list_http_logins", Command_list_http_logins);
@@ -3571,6 +3773,10 @@ static void ResetNode(INT32 node)
 	resendingsavegame[node] = false;
 	savegameresendcooldown[node] = 0;
 	gamestate_resend_counter[node] = 0;
+	nodecodecs[node] = 0;
+#ifdef JOININGAME
+	SV_FreeSaveBaseline(node);
+#endif
 
 	bannednode[node].banid = SIZE_MAX;
 	bannednode[node].timeleft = NO_BAN_TIME;
@@ -4120,6 +4326,12 @@ static void HandleConnect(SINT8 node)
 
 		// client authorised to join
 		nodewaiting[node] = (UINT8)(netbuffer->u.clientcfg.localplayers - playerpernode[node]);
+
+		// Older clients don't send their codecs
+		if (doomcom->datalength - BASEPACKETSIZE >= (INT16)sizeof (clientconfig_pak))
+			nodecodecs[node] = netbuffer->u.clientcfg.codecs & M_SupportedCodecs();
+		else
+			nodecodecs[node] = 0;
 		if (!nodeingame[node])
 		{
 			gamestate_t backupstate = gamestate;
@@ -4153,6 +4365,7 @@ static void HandleConnect(SINT8 node)
 		{
 			if (node && newnode)
 			{
+				SV_FreeSaveBaseline(node); // whatever it had was for someone else
 				SV_SendSaveGame(node, false); // send a complete game state
 				DEBFILE("send savegame\n");
 			}
@@ -4233,9 +4446,12 @@ static void PT_WillResendGamestate(void)
 		return;
 
 	// Send back a PT_CANRECEIVEGAMESTATE packet to the server
-	// so they know they can start sending the game state
+	// so they know they can start sending the game state,
+	// along with which one we already have
 	netbuffer->packettype = PT_CANRECEIVEGAMESTATE;
-	if (!HSendPacket(servernode, true, 0, 0))
+	netbuffer->u.gamestatebaseline.length = LONG((UINT32)cl_savebaselinelength);
+	M_Memcpy(netbuffer->u.gamestatebaseline.md5sum, cl_savebaselinemd5, 16);
+	if (!HSendPacket(servernode, true, 0, sizeof (gamestatebaseline_pak)))
 		return;
 
 	CONS_Printf(M_GetText("Reloading game state...\n"));
@@ -4257,7 +4473,14 @@ static void PT_CanReceiveGamestate(SINT8 node)
 
 	CONS_Printf(M_GetText("Resending game state to %s...\n"), player_names[nodetoplayer[node]]);
 
-	SV_SendSaveGame(node, true); // Resend a complete game state
+	// Only send the changes if the node has the same game state we last sent it.
+	if (doomcom->datalength - BASEPACKETSIZE < (INT16)sizeof (gamestatebaseline_pak)
+		|| !savebaseline[node]
+		|| (UINT32)LONG(netbuffer->u.gamestatebaseline.length) != savebaselinelength[node]
+		|| memcmp(netbuffer->u.gamestatebaseline.md5sum, savebaselinemd5[node], 16))
+		SV_FreeSaveBaseline(node);
+
+	SV_SendSaveGame(node, true); // Resend the game state
 	resendingsavegame[node] = true;
 }
 
@@ -5058,14 +5281,14 @@ static INT16 Consistancy(void)
 		ret += P_GetRandSeed();
 
 #ifdef MOBJCONSISTANCY
-	if (!thinkercap.next)
+	if (!thlist[THINK_MOBJ].next)
 	{
 		DEBFILE(va("Consistancy = %u\n", ret));
 		return ret;
 	}
 	if (gamestate == GS_LEVEL)
 	{
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -6042,6 +6265,7 @@ rewind_t *CL_RewindToTime(tic_t time)
 		return NULL;
 
 	save.buffer = save.p = rewindhead->savebuffer;
+	save.end = save.buffer + sizeof (rewindhead->savebuffer);
 
 	P_LoadNetGame(&save, false);
 	wipegamestate = gamestate; // No fading back in!
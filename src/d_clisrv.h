@@ -24,8 +24,11 @@
 The 'packet version' is used to distinguish packet formats.
 This version is independent of VERSION and SUBVERSION. Different
 applications may follow different packet versions.
+
+1: netgame saves no longer archive sector and line tag lists
+2: Lua net archives use varints and string back-references
 */
-#define PACKETVERSION 0
+#define PACKETVERSION 2
 
 // Network play related stuff.
 // There is a data struct that stores network
@@ -220,6 +223,7 @@ typedef struct
 	UINT8 subversion; // Contains build version
 	UINT8 localplayers;	// number of splitscreen players
 	UINT8 mode;
+	UINT8 codecs; // CODECBIT mask of the gamestate compression codecs we can decode
 } ATTRPACK clientconfig_pak;
 
 #define SV_SPEEDMASK 0x03		// used to send kartspeed
@@ -302,6 +306,13 @@ typedef struct
 	UINT8 ctfteam;
 } ATTRPACK plrconfig;
 
+// Which game state a client already has, so only the changes need resending.
+typedef struct
+{
+	UINT32 length; // 0 if none
+	UINT8 md5sum[16];
+} ATTRPACK gamestatebaseline_pak;
+
 typedef struct
 {
 	INT32 first;
@@ -341,6 +352,7 @@ typedef struct
 		INT32 filesneedednum;               //           4 bytes
 		filesneededconfig_pak filesneededcfg; //       ??? bytes
 		UINT32 pingtable[MAXPLAYERS+1];     //          68 bytes
+		gamestatebaseline_pak gamestatebaseline; //     20 bytes
 	} u; // This is needed to pack diff packet types data together
 } ATTRPACK doomdata_t;
 
@@ -421,7 +433,7 @@ extern consvar_t
 #ifdef VANILLAJOINNEXTROUND
 	cv_joinnextround,
 #endif
-	cv_netticbuffer, cv_allownewplayer, cv_joinrefusemessage, cv_maxplayers, cv_gamestateattempts, cv_resynchcooldown, cv_blamecfail, cv_maxsend, cv_noticedownload, cv_downloadspeed;
+	cv_netticbuffer, cv_allownewplayer, cv_joinrefusemessage, cv_maxplayers, cv_gamestateattempts, cv_resynchcooldown, cv_gamestatecodec, cv_blamecfail, cv_maxsend, cv_noticedownload, cv_downloadspeed;
 
 extern consvar_t cv_connectawaittime;
 
@@ -447,10 +447,15 @@ static boolean D_Display(void)
 
 			R_ApplyLevelInterpolators(R_UsingFrameInterpolation() ? rendertimefrac : FRACUNIT);
 
+			for (i = 0; i < MAXSPLITSCREENPLAYERS; i++)
+				ps_viewtimes[i].value.p = 0;
+
 			for (i = 0; i <= splitscreen; i++)
 			{
 				if (players[displayplayers[i]].mo || players[displayplayers[i]].playerstate == PST_DEAD)
 				{
+					PS_START_TIMING(ps_viewtimes[i]);
+
 					if (i == 0) // Initialize for P1
 					{
 						viewwindowy = 0;
@@ -508,6 +513,8 @@ static boolean D_Display(void)
 						if (i > 0)
 							M_Memcpy(ylookup, ylookup1, viewheight*sizeof (ylookup[0]));
 					}
+
+					PS_STOP_TIMING(ps_viewtimes[i]);
 				}
 			}
 
@@ -196,6 +196,11 @@ typedef struct
 	UINT8 remotefirstack;
 	UINT8 nextacknum;
 
+	// congestion stats, see Net_GetNodeFlow
+	UINT32 ackedpackets;
+	UINT32 resentpackets;
+	fixed_t rtt;
+
 	UINT8 flags;
 } node_t;
 
@@ -310,6 +315,29 @@ INT32 Net_GetFreeAcks(boolean urgent)
 	return n;
 }
 
+/** Gets what the ack system knows about how well packets get through to a node
+  *
+  * \param node The node
+  * \param flow Where to put it
+  *
+  */
+void Net_GetNodeFlow(INT32 node, nodeflow_t *flow)
+{
+	flow->acked = nodes[node].ackedpackets;
+	flow->resent = nodes[node].resentpackets;
+	flow->rtt = (tic_t)(nodes[node].rtt + FRACUNIT - 1)>>FRACBITS;
+	flow->inflight = 0;
+	flow->maxinflight = MAXACKTOSEND - 1;
+#ifndef NONET
+	{
+		INT32 i;
+		for (i = 0; i < MAXACKPACKETS; i++)
+			if (ackpak[i].acknum && ackpak[i].destinationnode == node)
+				flow->inflight++;
+	}
+#endif
+}
+
 // Get a ack to send in the queue of this node
 static UINT8 GetAcktosend(INT32 node)
 {
@@ -321,6 +349,18 @@ static void RemoveAck(INT32 i)
 {
 	INT32 node = ackpak[i].destinationnode;
 	DEBFILE(va("Remove ack %d\n",ackpak[i].acknum));
+
+	// Only first tries tell how long the round trip is
+	nodes[node].ackedpackets++;
+	if (!ackpak[i].resentnum && ackpak[i].senttime)
+	{
+		fixed_t sample = (I_GetTime() - ackpak[i].senttime)<<FRACBITS;
+		if (nodes[node].rtt)
+			nodes[node].rtt += (sample - nodes[node].rtt)/8;
+		else
+			nodes[node].rtt = max(sample, 1);
+	}
+
 	ackpak[i].acknum = 0;
 	if (nodes[node].flags & NF_CLOSE)
 		Net_CloseConnection(node);
@@ -524,6 +564,7 @@ void Net_AckTicker(void)
 			ackpak[i].senttime = I_GetTime();
 			ackpak[i].resentnum++;
 			ackpak[i].nextacknum = node->nextacknum;
+			node->resentpackets++;
 			retransmit++; // For stat
 			HSendPacket((INT32)(node - nodes), false, ackpak[i].acknum,
 				(size_t)(ackpak[i].length - BASEPACKETSIZE));
@@ -643,6 +684,8 @@ static void InitNode(node_t *node)
 	node->firstacktosend = 0;
 	node->nextacknum = 1;
 	node->remotefirstack = 0;
+	node->ackedpackets = node->resentpackets = 0;
+	node->rtt = 0;
 	node->flags = 0;
 }
 
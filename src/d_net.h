@@ -46,6 +46,18 @@ extern boolean nodeingame[MAXNETNODES]; // Set false as nodes leave game
 extern boolean serverrunning;
 
 INT32 Net_GetFreeAcks(boolean urgent);
+
+// Reliable packet stats of a node, for senders that pace themselves
+typedef struct
+{
+	UINT32 acked; // acknowledged so far, wraps
+	UINT32 resent; // resent because no ack came in time so far, wraps
+	INT32 inflight; // waiting for an ack right now
+	INT32 maxinflight; // the most that can wait for an ack at once
+	tic_t rtt; // smoothed round trip time in tics, rounded up, 0 if unknown
+} nodeflow_t;
+
+void Net_GetNodeFlow(INT32 node, nodeflow_t *flow);
 void Net_AckTicker(void);
 
 // If reliable return true if packet sent, 0 else
@@ -557,6 +557,17 @@ static CV_PossibleValue_t skinselectspin_cons_t[] = {
 	{0, "Off"}, {1, "Slow"}, {2, "2"}, {3, "3"}, {4, "4"}, {5, "5"}, {6, "6"}, {7, "7"}, {8, "8"}, {9, "9"}, {10, "Fast"}, {SKINSELECTSPIN_PAIN, "Pain"}, {0, NULL}};
 consvar_t cv_skinselectspin = {"skinselectspin", "5", CV_SAVE, skinselectspin_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 
+#ifdef THREADEDLOGIC
+// Splits order independent game logic across the job threads; results should be identical either way.
+// Not saved: until replays confirm Consistancy matches with it on, it starts off every session.
+consvar_t cv_threadedlogic = {"threadedlogic", "Off", 0, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+#endif
+
+// Microseconds of Lua garbage collection to run after each tic, 0 leaves it to Lua
+static CV_PossibleValue_t luagcbudget_cons_t[] = {
+	{0, "MIN"}, {20000, "MAX"}, {0, NULL}};
+consvar_t cv_luagcbudget = {"luagcbudget", "0", CV_SAVE, luagcbudget_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+
 static CV_PossibleValue_t perfstats_cons_t[] = {
 	{0, "Off"}, {1, "Rendering"}, {2, "Logic"}, {3, "ThinkFrame"}, {4, "PreThinkFrame"}, {5, "PostThinkFrame"}, {0, NULL}};
 consvar_t cv_perfstats = {"perfstats", "Off", CV_CALL, perfstats_cons_t, PS_PerfStats_OnChange, 0, NULL, NULL, 0, 0, NULL};
@@ -798,6 +809,7 @@ void D_RegisterServerCommands(void)
 	CV_RegisterVar(&cv_maxplayers);
 	CV_RegisterVar(&cv_gamestateattempts);
 	CV_RegisterVar(&cv_resynchcooldown);
+	CV_RegisterVar(&cv_gamestatecodec);
 	CV_RegisterVar(&cv_maxsend);
 	CV_RegisterVar(&cv_noticedownload);
 	CV_RegisterVar(&cv_downloadspeed);
@@ -1179,6 +1191,11 @@ void D_RegisterClientCommands(void)
 	CV_RegisterVar(&cv_driftgaugetrans);
 	CV_RegisterVar(&cv_driftgaugestyle);
 
+#ifdef THREADEDLOGIC
+	CV_RegisterVar(&cv_threadedlogic);
+#endif
+	CV_RegisterVar(&cv_luagcbudget);
+
 	CV_RegisterVar(&cv_perfstats);
 	CV_RegisterVar(&cv_ps_thinkframe_page);
 	CV_RegisterVar(&cv_ps_samplesize);
@@ -5873,10 +5890,14 @@ static void Command_Togglemodified_f(void)
 	modifiedgame = !modifiedgame;
 }
 
+// archivetest [runs]
+// Archives and unarchives the Lua state like a netgame join, and with
+// runs, times both and reports the size, to measure mods' net vars.
 static void Command_Archivetest_f(void)
 {
 	savebuffer_t save;
-	UINT32 i, wrote;
+	UINT32 i, wrote, run, runs = 1;
+	precise_t start, archivetime = 0, unarchivetime = 0;
 	thinker_t *th;
 	if (gamestate != GS_LEVEL)
 	{
@@ -5884,32 +5905,55 @@ static void Command_Archivetest_f(void)
 		return;
 	}
 
+	if (COM_Argc() > 1)
+		runs = max(atoi(COM_Argv(1)), 1);
+
 	// assign mobjnum
 	i = 1;
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
 			((mobj_t *)th)->mobjnum = i++;
 
-	// allocate buffer
-	save.buffer = save.p = ZZ_Alloc(1024);
-
-	// test archive
-	CONS_Printf("LUA_Archive...\n");
-	LUA_Archive(&save, true);
-	WRITEUINT8(save.p, 0x7F);
-	wrote = (UINT32)(save.p - save.buffer);
-
-	// clear Lua state, so we can really see what happens!
-	CONS_Printf("Clearing state!\n");
-	LUA_ClearExtVars();
-
-	// test unarchive
-	save.p = save.buffer;
-	CONS_Printf("LUA_UnArchive...\n");
-	LUA_UnArchive(&save, true);
-	i = READUINT8(save.p);
-	if (i != 0x7F || wrote != (UINT32)(save.p - save.buffer))
-		CONS_Printf("Savegame corrupted. (write %u, read %u)\n", wrote, (UINT32)(save.p - save.buffer));
+	// allocate buffer, as big as a netgame save
+	save.buffer = save.p = ZZ_Alloc(768*1024);
+	save.end = save.buffer + 768*1024;
+
+	for (run = 0; run < runs; run++)
+	{
+		// test archive
+		if (runs == 1)
+			CONS_Printf("LUA_Archive...\n");
+		save.p = save.buffer;
+		start = I_GetPreciseTime();
+		LUA_Archive(&save, true);
+		archivetime += I_GetPreciseTime() - start;
+		WRITEUINT8(save.p, 0x7F);
+		wrote = (UINT32)(save.p - save.buffer);
+
+		// clear Lua state, so we can really see what happens!
+		if (runs == 1)
+			CONS_Printf("Clearing state!\n");
+		LUA_ClearExtVars();
+
+		// test unarchive
+		save.p = save.buffer;
+		if (runs == 1)
+			CONS_Printf("LUA_UnArchive...\n");
+		start = I_GetPreciseTime();
+		LUA_UnArchive(&save, true);
+		unarchivetime += I_GetPreciseTime() - start;
+		i = READUINT8(save.p);
+		if (i != 0x7F || wrote != (UINT32)(save.p - save.buffer))
+		{
+			CONS_Printf("Savegame corrupted. (write %u, read %u)\n", wrote, (UINT32)(save.p - save.buffer));
+			break;
+		}
+	}
+
+	if (runs > 1)
+		CONS_Printf("%u bytes, archive %.2f ms, unarchive %.2f ms (average of %u runs)\n", wrote,
+			(double)archivetime * 1000.0 / I_GetPrecisePrecision() / runs,
+			(double)unarchivetime * 1000.0 / I_GetPrecisePrecision() / runs, runs);
 
 	// free buffer
 	Z_Free(save.buffer);
@@ -199,6 +199,11 @@ extern consvar_t cv_driftgaugeofs;
 extern consvar_t cv_driftgaugetrans;
 extern consvar_t cv_driftgaugestyle;
 
+#ifdef THREADEDLOGIC
+extern consvar_t cv_threadedlogic;
+#endif
+extern consvar_t cv_luagcbudget;
+
 extern consvar_t cv_perfstats;
 extern consvar_t cv_ps_thinkframe_page;
 extern consvar_t cv_ps_samplesize;
@@ -82,6 +82,7 @@ typedef struct filetx_s
 	} id;
 	UINT32 size; // Size of the file
 	UINT8 fileid;
+	UINT16 wadnum; // The loaded file it is, for SF_FILE
 	INT32 node; // Destination
 	struct filetx_s *next; // Next file in the list
 } filetx_t;
@@ -92,6 +93,13 @@ typedef struct filetran_s
 	filetx_t *txlist; // Linked list of all files for the node
 	UINT32 position; // The current position in the file
 	boolean init; // false if we want to reset position / open a new file
+
+	// Congestion control, see SV_UpdateFileSendWindow
+	fixed_t window; // How many packets can wait for an ack, 0 until the first update
+	fixed_t threshold; // Window size where growth slows down
+	UINT32 acked, resent; // Net_GetNodeFlow counts at the last update
+	tic_t losshold; // Don't back off again before this, the losses until then are already handled
+	INT32 budget; // Packets we can still send this tic
 } filetran_t;
 static filetran_t transfer[MAXNETNODES];
 
@@ -99,6 +107,7 @@ static filetran_t transfer[MAXNETNODES];
 typedef struct fileused_s
 {
 	FILE *file;
+	const UINT8 *data; // The file's mapping if it has one, used instead of file
 	UINT8 count;
 	UINT32 position;
 } fileused_t;
@@ -717,6 +726,7 @@ static boolean SV_SendFile(INT32 node, const char *filename, UINT8 fileid)
 	DEBFILE(va("Sending file %s (id=%d) to %d\n", filename, fileid, node));
 	p->ram = SF_FILE; // It's a file, we need to close it and free its name once we're done sending it
 	p->fileid = fileid;
+	p->wadnum = (UINT16)i;
 	p->next = NULL; // End of list
 	filestosend++;
 	return true;
@@ -777,7 +787,7 @@ static void SV_EndFileSend(INT32 node)
 		case SF_FILE: // It's a file, close it and free its filename
 			if (cv_noticedownload.value)
 				CONS_Printf("Ending file transfer (id %d) for node %d\n", p->fileid, node);
-			if (transferFiles[p->fileid].file)
+			if (transferFiles[p->fileid].file || transferFiles[p->fileid].data)
 			{
 				if (transferFiles[p->fileid].count > 0)
 				{
@@ -786,8 +796,10 @@ static void SV_EndFileSend(INT32 node)
 
 				if (transferFiles[p->fileid].count == 0)
 				{
-					fclose(transferFiles[p->fileid].file);
+					if (transferFiles[p->fileid].file)
+						fclose(transferFiles[p->fileid].file);
 					transferFiles[p->fileid].file = NULL;
+					transferFiles[p->fileid].data = NULL; // Owned by the wadfile
 				}
 			}
 			free(p->id.filename);
@@ -808,27 +820,85 @@ static void SV_EndFileSend(INT32 node)
 	// Indicate that the transmission is over
 	transfer[node].init = false;
 
+	// Probe the connection again next time
+	if (!transfer[node].txlist)
+		transfer[node].window = 0;
+
 	filestosend--;
 }
 
+#define FILETXSTARTWINDOW (4*FRACUNIT)
+#define FILETXMINWINDOW (2*FRACUNIT)
+#define FILETXLOSSHOLD (TICRATE/2) // Resends of packets sent before backing off keep coming for about this long
+
+/** Adjusts how many file fragments can be on their way to a node, from how
+  * many got acknowledged or resent since the last tic, like TCP Reno does.
+  * The window doubles every round trip at first, then grows by one packet
+  * per round trip, and is halved when packets get lost.
+  *
+  * \param node The destination
+  *
+  */
+static void SV_UpdateFileSendWindow(INT32 node)
+{
+	filetran_t *t = &transfer[node];
+	nodeflow_t flow;
+	UINT32 acked, resent;
+
+	Net_GetNodeFlow(node, &flow);
+	acked = flow.acked - t->acked;
+	resent = flow.resent - t->resent;
+	t->acked = flow.acked;
+	t->resent = flow.resent;
+
+	if (!t->window) // New transfer
+	{
+		t->window = FILETXSTARTWINDOW;
+		t->threshold = flow.maxinflight<<FRACBITS;
+		t->losshold = 0;
+	}
+	else if (resent)
+	{
+		if (I_GetTime() >= t->losshold)
+		{
+			t->threshold = max(t->window/2, FILETXMINWINDOW);
+			t->window = t->threshold;
+			t->losshold = I_GetTime() + flow.rtt + FILETXLOSSHOLD;
+		}
+	}
+	else if (acked)
+	{
+		if (t->window < t->threshold)
+			t->window += (fixed_t)acked<<FRACBITS;
+		else
+			t->window += FixedDiv((fixed_t)acked<<FRACBITS, t->window);
+	}
+
+	t->window = min(t->window, flow.maxinflight<<FRACBITS);
+	t->budget = (t->window>>FRACBITS) - flow.inflight;
+}
+
 /** Handles file transmission
   *
-  * \todo Use an acknowledging method more adapted to file transmission
-  *       The current download speed suffers from lack of ack packets,
-  *       especially when the one downloading has high latency
+  * Every node gets as many fragments as its congestion window allows,
+  * one at a time for each node in turn, up to cv_downloadspeed in total.
   *
   */
 void SV_FileSendTicker(void)
 {
 	static INT32 currentnode = 0;
+	filetx_t *f;
 	filetx_pak *p;
 	size_t size;
-	filetx_t *f;
 	INT32 packetsent, ram, i, j;
 
 	if (!filestosend) // No file to send
 		return;
 
+	for (i = 0; i < MAXNETNODES; i++)
+		if (transfer[i].txlist)
+			SV_UpdateFileSendWindow(i);
+
 	packetsent = cv_downloadspeed.value;
 
 	netbuffer->packettype = PT_FILEFRAGMENT;
@@ -838,11 +908,11 @@ void SV_FileSendTicker(void)
 		for (i = currentnode, j = 0; j < MAXNETNODES;
 			i = (i+1) % MAXNETNODES, j++)
 		{
-			if (transfer[i].txlist)
+			if (transfer[i].txlist && transfer[i].budget > 0)
 				goto found;
 		}
-		// no transfer to do
-		I_Error("filestosend=%d but no file to send found\n", filestosend);
+		// Every window is full
+		break;
 	found:
 		currentnode = (i+1) % MAXNETNODES;
 		f = transfer[i].txlist;
@@ -851,7 +921,18 @@ void SV_FileSendTicker(void)
 		// Open the file if it isn't open yet, or
 		if (transfer[i].init == false)
 		{
-			if (!ram) // Sending a file
+			if (!ram && wadfiles[f->wadnum]->mapping) // Sending a file we already have mapped
+			{
+				// Every node downloading it reads the same pages,
+				// and there is no handle to keep open.
+				transferFiles[f->fileid].data = wadfiles[f->wadnum]->mapping;
+
+				I_Assert(transferFiles[f->fileid].count < UINT8_MAX);
+				transferFiles[f->fileid].count++;
+
+				f->size = wadfiles[f->wadnum]->filesize;
+			}
+			else if (!ram) // Sending a file
 			{
 				long filesize;
 
@@ -889,7 +970,7 @@ void SV_FileSendTicker(void)
 			transfer[i].init = true; // Indicate that it is open
 		}
 
-		if (!ram)
+		if (!ram && !transferFiles[f->fileid].data)
 		{
 			// Seek to the right position if we aren't already there.
 			if (transferFiles[f->fileid].position != transfer[i].position)
@@ -911,6 +992,10 @@ void SV_FileSendTicker(void)
 		{
 			M_Memcpy(p->data, &f->id.ram[transfer[i].position], size);
 		}
+		else if (transferFiles[f->fileid].data)
+		{
+			M_Memcpy(p->data, &transferFiles[f->fileid].data[transfer[i].position], size);
+		}
 		else if (fread(p->data, 1, size, transferFiles[f->fileid].file) != size)
 		{
 			I_Error("SV_FileSendTicker: can't read %s byte on %s at %d because %s",
@@ -931,6 +1016,7 @@ void SV_FileSendTicker(void)
 		{
 			// Success
 			transfer[i].position = (UINT32)(transfer[i].position + size);
+			transfer[i].budget--;
 
 			if (transfer[i].position == f->size) // Finish?
 			{
@@ -939,9 +1025,9 @@ void SV_FileSendTicker(void)
 		}
 		else
 		{
-			// Not sent for some odd reason, retry at next call
-			// Exit the while (can't send this one so why should i send the next?)
-			break;
+			// Not sent, most likely out of acks, retry at next call
+			// Other nodes may still have room
+			transfer[i].budget = 0;
 		}
 	}
 }
@@ -46,9 +46,15 @@ typedef struct thinker_s
 	struct thinker_s *next;
 	think_t function;
 
+	// Order thinkers run in, across lists, see P_RunThinkers
+	struct thinker_s *runprev;
+	struct thinker_s *runnext;
+
 	// killough 11/98: count of how many other objects reference
 	// this one using pointers. Used for garbage collection.
 	INT32 references;
+
+	UINT8 list; // which thlist[] it is on, for perfstats
 } thinker_t;
 
 #endif
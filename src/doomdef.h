@@ -705,6 +705,10 @@ extern const char *compdate, *comptime, *comprevision, *compbranch;
 ///	Dumps the contents of a network save game upon consistency failure for debugging.
 //#define DUMPCONSISTENCY
 
+///	Adds the threadedlogic cvar, which updates dynamic slopes and interpolators on the job threads.
+///	Leave it off until demos and netreplays have been checked to stay in sync with it on.
+//#define THREADEDLOGIC
+
 ///	See name of player in your crosshair
 #define SEENAMES
 
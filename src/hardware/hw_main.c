@@ -4622,6 +4622,7 @@ static void HWR_AddPrecipitationSprites(void)
 	}
 
 	R_GetRenderBlockMapDimensions(drawdist, &xl, &xh, &yl, &yh);
+	P_UpdatePrecipitationBlocks(xl, xh, yl, yh);
 
 	for (bx = xl; bx <= xh; bx++)
 	{
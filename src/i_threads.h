@@ -27,6 +27,9 @@ void      I_spawn_thread (const char *name, I_thread_fn, void *userdata);
 /* check in your thread whether to return early */
 int       I_thread_is_stopped (void);
 
+/* number of logical CPU cores */
+int       I_cpu_count (void);
+
 void      I_lock_mutex      (I_mutex *);
 void      I_unlock_mutex    (I_mutex);
 
@@ -10,11 +10,11 @@
 /// \file  k_director.c
 /// \brief SRB2kart automatic spectator camera.
 
-//#include "k_kart.h"
 #include "doomdef.h"
 #include "g_game.h"
 #include "v_video.h"
 #include "k_director.h"
+#include "k_kart.h"
 #include "d_netcmd.h"
 #include "p_local.h"
 #include "st_stuff.h"
@@ -70,10 +70,9 @@ void K_InitDirector(void)
 	}
 }
 
-static fixed_t K_GetDistanceToFinish(player_t player)
+static mobj_t *K_GetFinishWaypoint(void)
 {
 	mobj_t *mo;
-	fixed_t dist = 0;
 	INT16 maxMoveCount = -1;
 	INT16 maxAngle = -1;
 
@@ -84,11 +83,7 @@ static fixed_t K_GetDistanceToFinish(player_t player)
 			if (mo->spawnpoint->angle != 0)
 				continue;
 
-			dist = P_AproxDistance(P_AproxDistance(mo->x - player.mo->x,
-												mo->y - player.mo->y),
-							mo->z - player.mo->z) / FRACUNIT;
-
-			break;
+			return mo;
 		}
 	}
 	else // crappy optimization weeeee
@@ -103,21 +98,17 @@ static fixed_t K_GetDistanceToFinish(player_t player)
 			if (!(mo->movecount == maxMoveCount && mo->spawnpoint->angle == maxAngle)) // sprint maps finishline waypoint is the one with highest movecount AND angle
 				continue;
 
-			dist = P_AproxDistance(P_AproxDistance(mo->x - player.mo->x,
-												   mo->y - player.mo->y),
-						  mo->z - player.mo->z) / FRACUNIT;
-
-			break;
+			return mo;
 		}
 	}
 
-	return dist;
+	return NULL;
 }
 
-static fixed_t K_GetFinishGap(INT32 leader, INT32 follower)
+static fixed_t K_GetFinishGap(INT32 leader, INT32 follower, const fixed_t *finishdist)
 {
-	fixed_t dista = K_GetDistanceToFinish(players[follower]);
-	fixed_t distb = K_GetDistanceToFinish(players[leader]);
+	fixed_t dista = finishdist[follower];
+	fixed_t distb = finishdist[leader];
 
 	if (players[follower].kartstuff[k_position] < players[leader].kartstuff[k_position])
 	{
@@ -134,17 +125,37 @@ static void K_UpdateDirectorPositions(void)
 	INT32 playernum;
 	INT32 position;
 	player_t* target;
+	mobj_t *finish = K_GetFinishWaypoint();
+	fixed_t finishdist[MAXPLAYERS]; // measured once per player, every gap needs two
 
 	memset(directorinfo.sortedplayers, -1, sizeof(directorinfo.sortedplayers));
+	memset(finishdist, 0, sizeof(finishdist));
+
+	if (finish)
+	{
+		playerquery_t query;
+		playerhit_t hits[MAXPLAYERS];
+		UINT8 i, numhits;
+
+		query.x = finish->x;
+		query.y = finish->y;
+		query.z = finish->z;
+		query.range = query.zrange = 0;
+		query.filter = NULL;
+		query.userdata = NULL;
+
+		numhits = K_FindPlayersInRange(&query, hits);
+
+		for (i = 0; i < numhits; i++)
+			finishdist[hits[i].player - players] = P_AproxDistance(hits[i].dist, finish->z - hits[i].player->mo->z) / FRACUNIT;
+	}
 
 	for (playernum = 0; playernum < MAXPLAYERS; playernum++)
 	{
 		target = &players[playernum];
 
 		if (playeringame[playernum] && !target->spectator && target->kartstuff[k_position] > 0)
-		{
 			directorinfo.sortedplayers[target->kartstuff[k_position] - 1] = playernum;
-		}
 	}
 
 	for (position = 0; position < MAXPLAYERS - 1; position++)
@@ -156,7 +167,7 @@ static void K_UpdateDirectorPositions(void)
 			continue;
 		}
 
-		directorinfo.gap[position] = ScaleFromMap(K_GetFinishGap(directorinfo.sortedplayers[position], directorinfo.sortedplayers[position + 1]), FRACUNIT);
+		directorinfo.gap[position] = ScaleFromMap(K_GetFinishGap(directorinfo.sortedplayers[position], directorinfo.sortedplayers[position + 1], finishdist), FRACUNIT);
 
 		if (directorinfo.gap[position] >= BREAKAWAYDIST)
 		{
@@ -174,7 +185,7 @@ static void K_UpdateDirectorPositions(void)
 		return;
 	}
 
-	directorinfo.maxdist = ScaleFromMap(K_GetDistanceToFinish(players[directorinfo.sortedplayers[0]]), FRACUNIT);
+	directorinfo.maxdist = ScaleFromMap(finishdist[directorinfo.sortedplayers[0]], FRACUNIT);
 }
 
 static boolean K_CanSwitchDirector(void)
@@ -5098,92 +5098,172 @@ static void K_MoveHeldObjects(player_t *player)
 	}
 }
 
-player_t *K_FindJawzTarget(mobj_t *actor, player_t *source)
+// Players who are in the game with a mobj, in player number order.
+// Only P_SpawnPlayer gives a player a mobj, so refreshing there and at the start of
+// every tic keeps everyone the game could look for in here. Everything else about
+// them moves during the tic, spectating included (Lua can set it at any time),
+// so it still has to be read from the player.
+UINT8 snapplayers[MAXPLAYERS];
+UINT8 numsnapplayers = 0;
+
+void K_UpdatePlayerSnapshot(void)
 {
-	fixed_t best = -1;
-	player_t *wtarg = NULL;
 	INT32 i;
 
+	numsnapplayers = 0;
+
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
-		angle_t thisang;
-		player_t *player;
-
-		if (!playeringame[i])
+		if (!playeringame[i] || !players[i].mo)
 			continue;
 
-		player = &players[i];
+		snapplayers[numsnapplayers++] = (UINT8)i;
+	}
+}
 
-		if (player->spectator)
-			continue; // spectator
+// Range and cone queries over the snapshot, for anything hunting for nearby players.
+// Everything is read live from the players' mobjs, so a query sees them where they
+// are right now, not where they were at the start of the tic.
+// Candidates are in the game, not spectating and have a mobj; the query's filter
+// decides the rest before any distance or angle is worked out. Hits come back in
+// player number order, so "first best wins" loops pick the same player as before.
+UINT8 K_FindPlayersInRange(const playerquery_t *query, playerhit_t *hits)
+{
+	UINT8 i, numhits = 0;
 
-		if (!player->mo)
+	for (i = 0; i < numsnapplayers; i++)
+	{
+		player_t *player = &players[snapplayers[i]];
+		fixed_t dist;
+
+		if (!playeringame[snapplayers[i]] || player->spectator || !player->mo)
 			continue;
 
-		if (player->mo->health <= 0)
-			continue; // dead
+		if (query->filter && !query->filter(player, query->userdata))
+			continue;
 
-		// Don't target yourself, stupid.
-		if (player == source)
+		if (query->zrange && abs(player->mo->z - query->z) > query->zrange)
 			continue;
 
-		// Don't home in on teammates.
-		if (G_GametypeHasTeams() && source->ctfteam == player->ctfteam)
+		dist = P_AproxDistance(player->mo->x - query->x, player->mo->y - query->y);
+
+		if (query->range && dist > query->range)
 			continue;
 
-		// Invisible, don't bother
-		if (player->kartstuff[k_hyudorotimer])
+		hits[numhits].player = player;
+		hits[numhits].dist = dist;
+		hits[numhits].angle = 0;
+		numhits++;
+	}
+
+	return numhits;
+}
+
+// Same as above, keeping only players within spread of facing, seen from x, y.
+// The apex is separate from the query point so moving things can measure range
+// from where they're headed but aim from where they are.
+UINT8 K_FindPlayersInCone(const playerquery_t *query, fixed_t x, fixed_t y, angle_t facing, angle_t spread, playerhit_t *hits)
+{
+	UINT8 i, numhits = 0;
+	const UINT8 numinrange = K_FindPlayersInRange(query, hits);
+
+	for (i = 0; i < numinrange; i++)
+	{
+		angle_t angle = facing - R_PointToAngle2(x, y, hits[i].player->mo->x, hits[i].player->mo->y);
+		if (angle > ANGLE_180)
+			angle = InvAngle(angle);
+
+		if (angle > spread)
 			continue;
 
-		// Find the angle, see who's got the best.
-		thisang = actor->angle - R_PointToAngle2(actor->x, actor->y, player->mo->x, player->mo->y);
-		if (thisang > ANGLE_180)
-			thisang = InvAngle(thisang);
+		hits[numhits] = hits[i];
+		hits[numhits].angle = angle;
+		numhits++;
+	}
 
-		// Jawz only go after the person directly ahead of you in race... sort of literally now!
-		if (G_RaceGametype())
-		{
-			// Don't go for people who are behind you
-			if (thisang > ANGLE_67h)
-				continue;
-			// Don't pay attention to people who aren't above your position
-			if (player->kartstuff[k_position] >= source->kartstuff[k_position])
-				continue;
-			if ((best == -1) || (player->kartstuff[k_position] > best))
-			{
-				wtarg = player;
-				best = player->kartstuff[k_position];
-			}
-		}
-		else
-		{
-			fixed_t thisdist;
-			fixed_t thisavg;
+	return numhits;
+}
 
-			// Don't go for people who are behind you
-			if (thisang > ANGLE_45)
-				continue;
+static boolean K_JawzCanTarget(player_t *player, void *userdata)
+{
+	player_t *source = userdata;
 
-			// Don't pay attention to dead players
-			if (player->kartstuff[k_bumper] <= 0)
-				continue;
+	if (player->mo->health <= 0)
+		return false; // dead
 
-			// Z pos too high/low
-			if (abs(player->mo->z - (actor->z + actor->momz)) > RING_DIST/8)
-				continue;
+	// Don't target yourself, stupid.
+	if (player == source)
+		return false;
 
-			thisdist = P_AproxDistance(player->mo->x - (actor->x + actor->momx), player->mo->y - (actor->y + actor->momy));
+	// Don't home in on teammates.
+	if (G_GametypeHasTeams() && source->ctfteam == player->ctfteam)
+		return false;
 
-			if (thisdist > 2*RING_DIST) // Don't go for people who are too far away
-				continue;
+	// Invisible, don't bother
+	if (player->kartstuff[k_hyudorotimer])
+		return false;
+
+	// Don't pay attention to people who aren't above your position
+	if (G_RaceGametype())
+		return (player->kartstuff[k_position] < source->kartstuff[k_position]);
+
+	// Don't pay attention to dead players
+	return (player->kartstuff[k_bumper] > 0);
+}
+
+player_t *K_FindJawzTarget(mobj_t *actor, player_t *source)
+{
+	playerquery_t query;
+	playerhit_t hits[MAXPLAYERS];
+	fixed_t best = -1;
+	player_t *wtarg = NULL;
+	UINT8 i, numhits;
+
+	query.filter = K_JawzCanTarget;
+	query.userdata = source;
+
+	// Jawz only go after the person directly ahead of you in race... sort of literally now!
+	if (G_RaceGametype())
+	{
+		query.x = actor->x;
+		query.y = actor->y;
+		query.z = actor->z;
+		query.range = query.zrange = 0;
+
+		// Don't go for people who are behind you
+		numhits = K_FindPlayersInCone(&query, actor->x, actor->y, actor->angle, ANGLE_67h, hits);
 
-			thisavg = (AngleFixed(thisang) + thisdist) / 2;
+		// Find the angle, see who's got the best.
+		for (i = 0; i < numhits; i++)
+		{
+			if ((best == -1) || (hits[i].player->kartstuff[k_position] > best))
+			{
+				wtarg = hits[i].player;
+				best = hits[i].player->kartstuff[k_position];
+			}
+		}
+	}
+	else
+	{
+		// Don't go for people who are too far away, or too high/low
+		query.x = actor->x + actor->momx;
+		query.y = actor->y + actor->momy;
+		query.z = actor->z + actor->momz;
+		query.range = 2*RING_DIST;
+		query.zrange = RING_DIST/8;
+
+		// Don't go for people who are behind you
+		numhits = K_FindPlayersInCone(&query, actor->x, actor->y, actor->angle, ANGLE_45, hits);
+
+		for (i = 0; i < numhits; i++)
+		{
+			const fixed_t thisavg = (AngleFixed(hits[i].angle) + hits[i].dist) / 2;
 
 			//CONS_Printf("got avg %d from player # %d\n", thisavg>>FRACBITS, i);
 
 			if ((best == -1) || (thisavg < best))
 			{
-				wtarg = player;
+				wtarg = hits[i].player;
 				best = thisavg;
 			}
 		}
@@ -5762,26 +5842,46 @@ void K_KartPlayerAfterThink(player_t *player)
 	}
 }
 
+typedef struct
+{
+	const player_t *spawnee;
+	fixed_t x, y;
+} respawncheck_t;
+
+static boolean K_PlayerBlocksRespawn(player_t *player, void *userdata)
+{
+	const respawncheck_t *check = userdata;
+	const fixed_t radius = check->spawnee->mo->radius + player->mo->radius;
+
+	if (player == check->spawnee || player->mo->health <= 0
+		|| player->playerstate != PST_LIVE || (player->mo->flags & MF_NOCLIP) || (player->mo->flags & MF_NOCLIPTHING))
+		return false;
+
+	// Box overlap, not a range, so spawn spots come out the same as they always have
+	return (abs(check->x - player->mo->x) < radius && abs(check->y - player->mo->y) < radius);
+}
+
 // Returns false if this player being placed here causes them to collide with any other player
 // Used in g_game.c for match etc. respawning
 // This does not check along the z because the z is not correctly set for the spawnee at this point
 boolean K_CheckPlayersRespawnColliding(INT32 playernum, fixed_t x, fixed_t y)
 {
-	INT32 i;
-	fixed_t p1radius = players[playernum].mo->radius;
-	for (i = 0; i < MAXPLAYERS; i++)
-	{
-		if (playernum == i || !playeringame[i] || players[i].spectator || !players[i].mo || players[i].mo->health <= 0
-			|| players[i].playerstate != PST_LIVE || (players[i].mo->flags & MF_NOCLIP) || (players[i].mo->flags & MF_NOCLIPTHING))
-			continue;
+	respawncheck_t check;
+	playerquery_t query;
+	playerhit_t hits[MAXPLAYERS];
 
-		if (abs(x - players[i].mo->x) < (p1radius + players[i].mo->radius)
-			&& abs(y - players[i].mo->y) < (p1radius + players[i].mo->radius))
-		{
-			return false;
-		}
-	}
-	return true;
+	check.spawnee = &players[playernum];
+	check.x = x;
+	check.y = y;
+
+	query.x = x;
+	query.y = y;
+	query.z = 0;
+	query.range = query.zrange = 0;
+	query.filter = K_PlayerBlocksRespawn;
+	query.userdata = &check;
+
+	return (K_FindPlayersInRange(&query, hits) == 0);
 }
 
 // countersteer is how strong the controls are telling us we are turning
@@ -6069,6 +6169,120 @@ static void K_KartDrift(player_t *player, boolean onground)
 	else
 		player->kartstuff[k_brakedrift] = 0;
 }
+// Checkpoint waypoints sorted by checkpoint number, so a player's distances
+// only look at the two checkpoints they are between.
+static mobj_t **checkwaypoints = NULL;
+static size_t numcheckwaypoints = 0;
+
+// The last distances worked out for each player, reused while they sit still
+static struct
+{
+	boolean valid;
+	fixed_t x, y, z;
+	INT32 starpostnum;
+	UINT8 laps;
+	INT32 prevcheck, nextcheck;
+} checkdists[MAXPLAYERS];
+
+static int K_CompareWaypointChecks(const void *a, const void *b)
+{
+	const mobj_t *mo1 = *(mobj_t *const *)a;
+	const mobj_t *mo2 = *(mobj_t *const *)b;
+	return (mo1->health > mo2->health) - (mo1->health < mo2->health);
+}
+
+static void K_BuildWaypointIndex(void)
+{
+	mobj_t *mo;
+	size_t count = 0;
+
+	for (mo = waypointcap; mo != NULL; mo = mo->tracer)
+		count++;
+
+	checkwaypoints = Z_Malloc(max(count, 1) * sizeof (*checkwaypoints), PU_LEVEL, &checkwaypoints);
+	numcheckwaypoints = 0;
+
+	for (mo = waypointcap; mo != NULL; mo = mo->tracer)
+		checkwaypoints[numcheckwaypoints++] = mo;
+
+	qsort(checkwaypoints, numcheckwaypoints, sizeof (*checkwaypoints), K_CompareWaypointChecks);
+}
+
+//
+// K_ClearWaypointIndex
+//
+// Forgets the waypoint index and every cached distance, for when the waypoint chain is rebuilt.
+//
+void K_ClearWaypointIndex(void)
+{
+	Z_Free(checkwaypoints);
+	checkwaypoints = NULL;
+	numcheckwaypoints = 0;
+	memset(checkdists, 0, sizeof (checkdists));
+}
+
+// Average distance to the waypoints of one checkpoint on this lap, in map units.
+static INT32 K_CheckpointDistance(player_t *player, INT32 check)
+{
+	size_t lo = 0, hi = numcheckwaypoints;
+	INT32 dist = 0;
+	fixed_t count = 0;
+
+	while (lo < hi)
+	{
+		size_t mid = lo + (hi - lo)/2;
+		if (checkwaypoints[mid]->health < check)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	for (; lo < numcheckwaypoints && checkwaypoints[lo]->health == check; lo++)
+	{
+		mobj_t *mo = checkwaypoints[lo];
+
+		if (mo->movecount && mo->movecount != player->laps+1)
+			continue;
+
+		dist += P_AproxDistance(P_AproxDistance(	mo->x - player->mo->x,
+													mo->y - player->mo->y),
+													mo->z - player->mo->z) / FRACUNIT;
+		count++;
+	}
+
+	if (count > 1)
+		dist /= count;
+
+	return dist;
+}
+
+// Sets k_prevcheck and k_nextcheck, only measuring again if the player moved.
+static void K_UpdateCheckpointDistances(player_t *player)
+{
+	INT32 pnum = player - players;
+	mobj_t *pmo = player->mo;
+
+	if (!checkwaypoints)
+		K_BuildWaypointIndex();
+
+	if (!checkdists[pnum].valid
+		|| checkdists[pnum].x != pmo->x || checkdists[pnum].y != pmo->y || checkdists[pnum].z != pmo->z
+		|| checkdists[pnum].starpostnum != player->starpostnum || checkdists[pnum].laps != player->laps)
+	{
+		checkdists[pnum].valid = true;
+		checkdists[pnum].x = pmo->x;
+		checkdists[pnum].y = pmo->y;
+		checkdists[pnum].z = pmo->z;
+		checkdists[pnum].starpostnum = player->starpostnum;
+		checkdists[pnum].laps = player->laps;
+		checkdists[pnum].prevcheck = K_CheckpointDistance(player, player->starpostnum);
+		checkdists[pnum].nextcheck = K_CheckpointDistance(player, player->starpostnum + 1);
+	}
+
+	player->kartstuff[k_prevcheck] = checkdists[pnum].prevcheck;
+	player->kartstuff[k_nextcheck] = checkdists[pnum].nextcheck;
+}
+
 //
 // K_KartUpdatePosition
 //
@@ -6076,9 +6290,7 @@ void K_KartUpdatePosition(player_t *player)
 {
 	fixed_t position = 1;
 	fixed_t oldposition = player->kartstuff[k_position];
-	fixed_t i, ppcd, pncd, ipcd, incd;
-	fixed_t pmo, imo;
-	mobj_t *mo;
+	fixed_t i;
 
 	if (player->spectator || !player->mo)
 		return;
@@ -6096,47 +6308,8 @@ void K_KartUpdatePosition(player_t *player)
 			else if (((players[i].starpostnum) + (numstarposts+1)*players[i].laps) ==
 				((player->starpostnum) + (numstarposts+1)*player->laps))
 			{
-				ppcd = pncd = ipcd = incd = 0;
-
-				player->kartstuff[k_prevcheck] = players[i].kartstuff[k_prevcheck] = 0;
-				player->kartstuff[k_nextcheck] = players[i].kartstuff[k_nextcheck] = 0;
-
-				// This checks every thing on the map, and looks for MT_BOSS3WAYPOINT (the thing we're using for checkpoint wp's, for now)
-				for (mo = waypointcap; mo != NULL; mo = mo->tracer)
-				{
-					pmo = P_AproxDistance(P_AproxDistance(	mo->x - player->mo->x,
-															mo->y - player->mo->y),
-															mo->z - player->mo->z) / FRACUNIT;
-					imo = P_AproxDistance(P_AproxDistance(	mo->x - players[i].mo->x,
-															mo->y - players[i].mo->y),
-															mo->z - players[i].mo->z) / FRACUNIT;
-
-					if (mo->health == player->starpostnum && (!mo->movecount || mo->movecount == player->laps+1))
-					{
-						player->kartstuff[k_prevcheck] += pmo;
-						ppcd++;
-					}
-					if (mo->health == (player->starpostnum + 1) && (!mo->movecount || mo->movecount == player->laps+1))
-					{
-						player->kartstuff[k_nextcheck] += pmo;
-						pncd++;
-					}
-					if (mo->health == players[i].starpostnum && (!mo->movecount || mo->movecount == players[i].laps+1))
-					{
-						players[i].kartstuff[k_prevcheck] += imo;
-						ipcd++;
-					}
-					if (mo->health == (players[i].starpostnum + 1) && (!mo->movecount || mo->movecount == players[i].laps+1))
-					{
-						players[i].kartstuff[k_nextcheck] += imo;
-						incd++;
-					}
-				}
-
-				if (ppcd > 1) player->kartstuff[k_prevcheck] /= ppcd;
-				if (pncd > 1) player->kartstuff[k_nextcheck] /= pncd;
-				if (ipcd > 1) players[i].kartstuff[k_prevcheck] /= ipcd;
-				if (incd > 1) players[i].kartstuff[k_nextcheck] /= incd;
+				K_UpdateCheckpointDistances(player);
+				K_UpdateCheckpointDistances(&players[i]);
 
 				if ((players[i].kartstuff[k_nextcheck] > 0 || player->kartstuff[k_nextcheck] > 0) && !player->exiting)
 				{
@@ -9643,7 +9816,7 @@ static boolean K_GetScreenCoords(vector2_t *vec, player_t *player, mobj_t *targe
 //Decided to port and highly modify sunflower version for the main nametag drawing with additions by NepDisk. My previous one was broken anyway due to the changed screencoords and noscalestart
 static void K_drawNameTags(void)
 {
-	UINT8 i,j;
+	UINT8 i,j,snap;
 	INT32 trans = 0;
 	vector2_t pos = {0};
 	fixed_t tagwidth;
@@ -9665,14 +9838,16 @@ static void K_drawNameTags(void)
 	// True if currently viewed player is flipped and has flipcam on
 	flipcam = (stplyr->pflags & PF_FLIPCAM) && (stplyr->mo->eflags & MFE_VERTICALFLIP);
 
-	for (i = 0; i < MAXPLAYERS; i++)
+	for (snap = 0; snap < numsnapplayers; snap++)
 	{
 		UINT8 *cm;
 		fixed_t distance = 0;
 		fixed_t maxdistance = (10*cv_nametagdist.value)* mapobjectscale;
 		flipped = 0;
 		fixed_t z;
-		
+
+		i = snapplayers[snap];
+
 		if (i > PLAYERSMASK)
 			continue;
 		if (!players[i].mo || P_MobjWasRemoved(players[i].mo) || players[i].spectator || !playeringame[i])
@@ -69,10 +69,33 @@ void K_KillBananaChain(mobj_t *banana, mobj_t *inflictor, mobj_t *source);
 void K_UpdateHnextList(player_t *player, boolean clean);
 void K_DropHnextList(player_t *player);
 void K_RepairOrbitChain(mobj_t *orbit);
+extern UINT8 snapplayers[MAXPLAYERS];
+extern UINT8 numsnapplayers;
+void K_UpdatePlayerSnapshot(void);
+
+typedef struct
+{
+	fixed_t x, y, z; // where distance and height are measured from
+	fixed_t range;   // furthest P_AproxDistance on the xy plane, 0 for no limit
+	fixed_t zrange;  // biggest height difference, 0 for no limit
+	boolean (*filter)(player_t *player, void *userdata); // run before any geometry, NULL takes everyone
+	void *userdata;
+} playerquery_t;
+
+typedef struct
+{
+	player_t *player;
+	fixed_t dist;  // xy distance from the query point
+	angle_t angle; // how far off the facing, cone queries only
+} playerhit_t;
+
+UINT8 K_FindPlayersInRange(const playerquery_t *query, playerhit_t *hits);
+UINT8 K_FindPlayersInCone(const playerquery_t *query, fixed_t x, fixed_t y, angle_t facing, angle_t spread, playerhit_t *hits);
 player_t *K_FindJawzTarget(mobj_t *actor, player_t *source);
 boolean K_CheckPlayersRespawnColliding(INT32 playernum, fixed_t x, fixed_t y);
 INT16 K_GetKartTurnValue(player_t *player, INT16 turnvalue);
 INT32 K_GetKartDriftSparkValue(player_t *player);
+void K_ClearWaypointIndex(void);
 void K_KartUpdatePosition(player_t *player);
 void K_DropItems(player_t *player);
 void K_DropRocketSneaker(player_t *player);
@@ -87,15 +87,25 @@ struct hook_s
 };
 typedef struct hook_s* hook_p;
 
-// For each mobj type, a linked list to its thinker and collision hooks.
-// That way, we don't have to iterate through all the hooks.
-// We could do that with all other mobj hooks, but it would probably just be
-// a waste of memory since they are only called occasionally. Probably...
-static hook_p mobjthinkerhooks[NUMMOBJTYPES];
-static hook_p mobjcollidehooks[NUMMOBJTYPES];
+// The hooks that take a mobj type, hook_MobjSpawn through hook_MobjRemoved.
+#define NUMMOBJHOOKS (hook_MobjRemoved - hook_MobjSpawn + 1)
+#define MOBJHOOKBIT(which) (1<<((which) - hook_MobjSpawn))
+
+// For each mobj type, a NULL terminated array per hook of the hooks to run,
+// in the order they were added. Only types that have hooks get one, and
+// mobjhookmask says which hooks they have, so a hook that doesn't apply to
+// a mobj is skipped without touching the Lua stack.
+typedef struct
+{
+	hook_p *hooks[NUMMOBJHOOKS];
+	UINT16 numhooks[NUMMOBJHOOKS];
+} mobjhooks_t;
+
+static mobjhooks_t *mobjhooks[NUMMOBJTYPES];
+static UINT16 mobjhookmask[NUMMOBJTYPES];
 
-// For each mobj type, a linked list for other mobj hooks
-static hook_p mobjhooks[NUMMOBJTYPES];
+// Registry reference to the table of hook functions, indexed by hook id.
+static int hooksref = LUA_NOREF;
 
 // A linked list for player hooks
 static hook_p playerhooks;
@@ -106,6 +116,40 @@ static hook_p linedefexecutorhooks;
 // For other hooks, a unique linked list
 hook_p roothook;
 
+// Is there a generic or type specific hook of this kind for mobjs of this type?
+static inline boolean MobjHooked(mobjtype_t mt, enum hook which)
+{
+	return ((mobjhookmask[MT_NULL] | mobjhookmask[mt]) & MOBJHOOKBIT(which)) != 0;
+}
+
+// The n-th hook of this kind for this type, or NULL after the last one.
+// A hook can call addHook and reallocate the array, so callers go by index
+// and come back here for every hook instead of keeping a pointer into it.
+static inline hook_p MobjHook(mobjtype_t mt, enum hook which, UINT16 n)
+{
+	const INT32 i = which - hook_MobjSpawn;
+
+	if (!(mobjhookmask[mt] & MOBJHOOKBIT(which)) || n >= mobjhooks[mt]->numhooks[i])
+		return NULL;
+	return mobjhooks[mt]->hooks[i][n];
+}
+
+static void AddMobjHook(hook_p hookp)
+{
+	const mobjtype_t mt = hookp->s.mt;
+	const INT32 i = hookp->type - hook_MobjSpawn;
+	mobjhooks_t *hooks = mobjhooks[mt];
+
+	if (!hooks)
+		hooks = mobjhooks[mt] = Z_Calloc(sizeof (*hooks), PU_STATIC, NULL);
+
+	hooks->hooks[i] = Z_Realloc(hooks->hooks[i], (hooks->numhooks[i] + 2) * sizeof (hook_p), PU_STATIC, NULL);
+	hooks->hooks[i][hooks->numhooks[i]++] = hookp;
+	hooks->hooks[i][hooks->numhooks[i]] = NULL;
+
+	mobjhookmask[mt] |= MOBJHOOKBIT(hookp->type);
+}
+
 // Takes hook, function, and additional arguments (mobj type to act on, etc.)
 static int lib_addHook(lua_State *L)
 {
@@ -182,26 +226,22 @@ static int lib_addHook(lua_State *L)
 	// set hook.id to the highest id + 1
 	hook.id = nextid++;
 
-	// Special cases for some hook types (see the comments above mobjthinkerhooks declaration)
+	// Special cases for some hook types (see the comments above mobjhooks declaration)
 	switch(hook.type)
 	{
-	case hook_MobjThinker:
-		lastp = &mobjthinkerhooks[hook.s.mt];
-		break;
+	case hook_MobjSpawn:
 	case hook_MobjCollide:
 	case hook_MobjMoveCollide:
-		lastp = &mobjcollidehooks[hook.s.mt];
-		break;
-	case hook_MobjSpawn:
 	case hook_TouchSpecial:
 	case hook_MobjFuse:
+	case hook_MobjThinker:
 	case hook_BossThinker:
 	case hook_ShouldDamage:
 	case hook_MobjDamage:
 	case hook_MobjDeath:
 	case hook_BossDeath:
 	case hook_MobjRemoved:
-		lastp = &mobjhooks[hook.s.mt];
+		lastp = NULL;
 		break;
 	case hook_JumpSpecial:
 	case hook_AbilitySpecial:
@@ -226,18 +266,24 @@ static int lib_addHook(lua_State *L)
 		break;
 	}
 
-	// iterate the hook metadata structs
-	// set lastp to the last hook struct's "next" pointer.
-	for (hookp = *lastp; hookp; hookp = hookp->next)
-		lastp = &hookp->next;
 	// allocate a permanent memory struct to stuff hook.
 	hookp = ZZ_Alloc(sizeof(struct hook_s));
 	memcpy(hookp, &hook, sizeof(struct hook_s));
-	// tack it onto the end of the linked list.
-	*lastp = hookp;
+
+	if (!lastp)
+		AddMobjHook(hookp);
+	else
+	{
+		// iterate the hook metadata structs
+		// set lastp to the last hook struct's "next" pointer.
+		while (*lastp)
+			lastp = &(*lastp)->next;
+		// tack it onto the end of the linked list.
+		*lastp = hookp;
+	}
 
 	// set the hook function in the registry.
-	lua_getfield(L, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(L, LUA_REGISTRYINDEX, hooksref);
 	lua_pushvalue(L, 1);
 	lua_rawseti(L, -2, hook.id);
 	return 0;
@@ -250,7 +296,7 @@ int LUA_HookLib(lua_State *L)
 	lua_register(L, "addHook", lib_addHook);
 
 	lua_newtable(L);
-	lua_setfield(L, LUA_REGISTRYINDEX, "hooks");
+	hooksref = luaL_ref(L, LUA_REGISTRYINDEX);
 
 	return 0;
 }
@@ -258,6 +304,7 @@ int LUA_HookLib(lua_State *L)
 boolean LUAh_MobjHook(mobj_t *mo, enum hook which)
 {
 	hook_p hookp;
+	UINT16 hooknum;
 	boolean hooked = false;
 	int HOOKSINDEX;
 	if (!gL || !(hooksAvailable[which/8] & (1<<(which%8))))
@@ -265,22 +312,19 @@ boolean LUAh_MobjHook(mobj_t *mo, enum hook which)
 
 	I_Assert(mo->type < NUMMOBJTYPES);
 
-	if (!(mobjhooks[MT_NULL] || mobjhooks[mo->type]))
+	if (!MobjHooked(mo->type, which))
 		return false;
 
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
 	// Look for all generic mobj hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(MT_NULL, which, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != which)
-			continue;
-
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
@@ -298,11 +342,8 @@ boolean LUAh_MobjHook(mobj_t *mo, enum hook which)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[mo->type]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(mo->type, which, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != which)
-			continue;
-
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
@@ -335,7 +376,7 @@ boolean LUAh_PlayerHook(player_t *plr, enum hook which)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -376,7 +417,7 @@ void LUAh_MapChange(INT16 mapnumber)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -409,7 +450,7 @@ void LUAh_MapLoad(void)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -442,7 +483,7 @@ void LUAh_PlayerJoin(int playernum)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -477,7 +518,7 @@ void LUAh_PreThinkFrame(void)
 
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -524,7 +565,7 @@ void LUAh_ThinkFrame(void)
 
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -570,7 +611,7 @@ void LUAh_PostThinkFrame(void)
 
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -614,7 +655,7 @@ void LUAh_IntermissionThinker(void)
 
 	lua_pushcfunction(gL, LUA_GetErrorMessage);;
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -646,7 +687,7 @@ void LUAh_VoteThinker(void)
 
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -672,6 +713,7 @@ void LUAh_VoteThinker(void)
 UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 {
 	hook_p hookp;
+	UINT16 hooknum;
 	UINT8 shouldCollide = 0; // 0 = default, 1 = force yes, 2 = force no.
 	int HOOKSINDEX;
 	if (!gL || !(hooksAvailable[which/8] & (1<<(which%8))))
@@ -679,22 +721,19 @@ UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 
 	I_Assert(thing1->type < NUMMOBJTYPES);
 
-	if (!(mobjcollidehooks[MT_NULL] || mobjcollidehooks[thing1->type]))
+	if (!MobjHooked(thing1->type, which))
 		return 0;
 
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
 	// Look for all generic mobj collision hooks
-	for (hookp = mobjcollidehooks[MT_NULL]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(MT_NULL, which, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != which)
-			continue;
-
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
 		{
@@ -721,11 +760,8 @@ UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjcollidehooks[thing1->type]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(thing1->type, which, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != which)
-			continue;
-
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
 		{
@@ -760,6 +796,7 @@ UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 boolean LUAh_MobjThinker(mobj_t *mo)
 {
 	hook_p hookp;
+	UINT16 hooknum;
 	boolean hooked = false;
 	int HOOKSINDEX;
 	if (!gL || !(hooksAvailable[hook_MobjThinker/8] & (1<<(hook_MobjThinker%8))))
@@ -767,18 +804,18 @@ boolean LUAh_MobjThinker(mobj_t *mo)
 
 	I_Assert(mo->type < NUMMOBJTYPES);
 
-	if (!(mobjthinkerhooks[MT_NULL] || mobjthinkerhooks[mo->type]))
+	if (!MobjHooked(mo->type, hook_MobjThinker))
 		return false;
 
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
 	// Look for all generic mobj thinker hooks
-	for (hookp = mobjthinkerhooks[MT_NULL]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(MT_NULL, hook_MobjThinker, hooknum)) != NULL; hooknum++)
 	{
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
@@ -797,7 +834,7 @@ boolean LUAh_MobjThinker(mobj_t *mo)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjthinkerhooks[mo->type]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(mo->type, hook_MobjThinker, hooknum)) != NULL; hooknum++)
 	{
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
@@ -824,6 +861,7 @@ boolean LUAh_MobjThinker(mobj_t *mo)
 boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 {
 	hook_p hookp;
+	UINT16 hooknum;
 	boolean hooked = false;
 	int HOOKSINDEX;
 	if (!gL || !(hooksAvailable[hook_TouchSpecial/8] & (1<<(hook_TouchSpecial%8))))
@@ -831,22 +869,19 @@ boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 
 	I_Assert(special->type < NUMMOBJTYPES);
 
-	if (!(mobjhooks[MT_NULL] || mobjhooks[special->type]))
+	if (!MobjHooked(special->type, hook_TouchSpecial))
 		return false;
 
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
 	// Look for all generic touch special hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(MT_NULL, hook_TouchSpecial, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != hook_TouchSpecial)
-			continue;
-
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
 		{
@@ -868,11 +903,8 @@ boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[special->type]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(special->type, hook_TouchSpecial, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != hook_TouchSpecial)
-			continue;
-
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
 		{
@@ -902,6 +934,7 @@ boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32 damage)
 {
 	hook_p hookp;
+	UINT16 hooknum;
 	UINT8 shouldDamage = 0; // 0 = default, 1 = force yes, 2 = force no.
 	int HOOKSINDEX;
 	if (!gL || !(hooksAvailable[hook_ShouldDamage/8] & (1<<(hook_ShouldDamage%8))))
@@ -909,22 +942,19 @@ UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 
 	I_Assert(target->type < NUMMOBJTYPES);
 
-	if (!(mobjhooks[MT_NULL] || mobjhooks[target->type]))
+	if (!MobjHooked(target->type, hook_ShouldDamage))
 		return 0;
 
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
 	// Look for all generic should damage hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(MT_NULL, hook_ShouldDamage, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != hook_ShouldDamage)
-			continue;
-
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
 		{
@@ -955,11 +985,8 @@ UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(target->type, hook_ShouldDamage, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != hook_ShouldDamage)
-			continue;
-
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
 		{
@@ -998,6 +1025,7 @@ UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32 damage)
 {
 	hook_p hookp;
+	UINT16 hooknum;
 	boolean hooked = false;
 	int HOOKSINDEX;
 	if (!gL || !(hooksAvailable[hook_MobjDamage/8] & (1<<(hook_MobjDamage%8))))
@@ -1005,22 +1033,19 @@ boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 
 	I_Assert(target->type < NUMMOBJTYPES);
 
-	if (!(mobjhooks[MT_NULL] || mobjhooks[target->type]))
+	if (!MobjHooked(target->type, hook_MobjDamage))
 		return false;
 
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
 	// Look for all generic mobj damage hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(MT_NULL, hook_MobjDamage, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != hook_MobjDamage)
-			continue;
-
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
 		{
@@ -1046,11 +1071,8 @@ boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(target->type, hook_MobjDamage, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != hook_MobjDamage)
-			continue;
-
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
 		{
@@ -1084,6 +1106,7 @@ boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source)
 {
 	hook_p hookp;
+	UINT16 hooknum;
 	boolean hooked = false;
 	int HOOKSINDEX;
 	if (!gL || !(hooksAvailable[hook_MobjDeath/8] & (1<<(hook_MobjDeath%8))))
@@ -1091,22 +1114,19 @@ boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source)
 
 	I_Assert(target->type < NUMMOBJTYPES);
 
-	if (!(mobjhooks[MT_NULL] || mobjhooks[target->type]))
+	if (!MobjHooked(target->type, hook_MobjDeath))
 		return false;
 
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
 	// Look for all generic mobj death hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(MT_NULL, hook_MobjDeath, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != hook_MobjDeath)
-			continue;
-
 		if (lua_gettop(gL) == 2)
 		{
 			LUA_PushUserdata(gL, target, META_MOBJ);
@@ -1129,11 +1149,8 @@ boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
+	for (hooknum = 0; (hookp = MobjHook(target->type, hook_MobjDeath, hooknum)) != NULL; hooknum++)
 	{
-		if (hookp->type != hook_MobjDeath)
-			continue;
-
 		ps_lua_mobjhooks.value.i++;
 		if (lua_gettop(gL) == 2)
 		{
@@ -1173,7 +1190,7 @@ boolean LUAh_BotTiccmd(player_t *bot, ticcmd_t *cmd)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1219,7 +1236,7 @@ boolean LUAh_PlayerCmd(player_t *player, ticcmd_t *cmd)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1266,7 +1283,7 @@ boolean LUAh_BotAI(mobj_t *sonic, mobj_t *tails, ticcmd_t *cmd)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1334,7 +1351,7 @@ boolean LUAh_LinedefExecute(line_t *line, mobj_t *mo, sector_t *sector)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1379,7 +1396,7 @@ boolean LUAh_PlayerMsg(int source, int target, int flags, char *msg, int mute)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1444,7 +1461,7 @@ boolean LUAh_HurtMsg(player_t *player, mobj_t *inflictor, mobj_t *source)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1495,7 +1512,7 @@ void LUAh_NetArchiveHook(lua_CFunction archFunc, savebuffer_t *save)
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 	errorhandlerindex = lua_gettop(gL);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1532,7 +1549,7 @@ void LUAh_PlayerQuit(player_t *plr, int reason)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1572,7 +1589,7 @@ boolean LUAh_MusicChange(const char *oldname, char *newname, UINT16 *mflags, boo
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1636,7 +1653,7 @@ UINT8 LUAh_ShouldSpin(player_t *player, mobj_t *inflictor, mobj_t *source)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1691,7 +1708,7 @@ UINT8 LUAh_ShouldExplode(player_t *player, mobj_t *inflictor, mobj_t *source)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1746,7 +1763,7 @@ UINT8 LUAh_ShouldSquish(player_t *player, mobj_t *inflictor, mobj_t *source)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1801,7 +1818,7 @@ boolean LUAh_PlayerSpin(player_t *player, mobj_t *inflictor, mobj_t *source)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1851,7 +1868,7 @@ boolean LUAh_PlayerSquish(player_t *player, mobj_t *inflictor, mobj_t *source)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1901,7 +1918,7 @@ boolean LUAh_PlayerExplode(player_t *player, mobj_t *inflictor, mobj_t *source)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
@@ -1949,7 +1966,7 @@ void LUAh_ServerJoin(void)
 	lua_settop(gL, 0);
 	lua_pushcfunction(gL, LUA_GetErrorMessage);
 
-	lua_getfield(gL, LUA_REGISTRYINDEX, "hooks");
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hooksref);
 	HOOKSINDEX = lua_gettop(gL);
 	I_Assert(lua_istable(L, HOOKSINDEX));
 
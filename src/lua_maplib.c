@@ -16,6 +16,7 @@
 #include "p_setup.h"
 #include "z_zone.h"
 #include "p_slopes.h"
+#include "p_tags.h"
 #include "r_main.h"
 
 #include "lua_udatalib.h"
@@ -250,6 +251,7 @@ static const char *const vector_opt[] = {
 	NULL};
 
 static const char *const array_opt[] ={"iterate",NULL};
+static const char *const tagged_array_opt[] ={"iterate","tagged",NULL};
 static const char *const valid_opt[] ={"valid",NULL};
 
 #define pushsubsector(L, subsector) LUA_PushUserdata(L, subsector, META_SUBSECTOR)
@@ -675,11 +677,11 @@ static int line_get(lua_State *L)
 	case line_backsector:
 		LUA_PushUserdata(L, line->backsector, META_SECTOR);
 		return 1;
-	case line_firsttag:
-		lua_pushinteger(L, line->firsttag);
+	case line_firsttag: // first line with the same tag
+		lua_pushinteger(L, Tag_Next(tags_lines, line->tag, -1));
 		return 1;
-	case line_nexttag:
-		lua_pushinteger(L, line->nexttag);
+	case line_nexttag: // next line with the same tag
+		lua_pushinteger(L, Tag_Next(tags_lines, line->tag, (INT32)(line - lines)));
 		return 1;
 	case line_text:
 		lua_pushstring(L, line->text);
@@ -883,6 +885,32 @@ static int lib_iterateSectors(lua_State *L)
 	return 0;
 }
 
+// for sector in sectors.tagged(tag) do
+static int lib_iterateSectorsTagged(lua_State *L)
+{
+	INT32 i = -1;
+	if (lua_gettop(L) < 2)
+		return luaL_error(L, "Don't call sectors.tagged() iterators directly, use them as 'for sector in sectors.tagged(tag) do <block> end'.");
+	lua_settop(L, 2);
+	lua_remove(L, 1); // state is unused.
+	if (!lua_isnil(L, 1))
+		i = (INT32)(*((sector_t **)luaL_checkudata(L, 1, META_SECTOR)) - sectors);
+	i = P_FindSectorFromTag((INT16)lua_tointeger(L, lua_upvalueindex(1)), i);
+	if (i >= 0)
+	{
+		LUA_PushUserdata(L, &sectors[i], META_SECTOR);
+		return 1;
+	}
+	return 0;
+}
+
+static int lib_sectorsTagged(lua_State *L)
+{
+	lua_pushinteger(L, luaL_checkinteger(L, 1));
+	lua_pushcclosure(L, lib_iterateSectorsTagged, 1);
+	return 1;
+}
+
 static int lib_getSector(lua_State *L)
 {
 	int field;
@@ -896,12 +924,15 @@ static int lib_getSector(lua_State *L)
 		LUA_PushUserdata(L, &sectors[i], META_SECTOR);
 		return 1;
 	}
-	field = luaL_checkoption(L, 1, NULL, array_opt);
+	field = luaL_checkoption(L, 1, NULL, tagged_array_opt);
 	switch(field)
 	{
 	case 0: // iterate
 		lua_pushcfunction(L, lib_iterateSectors);
 		return 1;
+	case 1: // tagged
+		lua_pushcfunction(L, lib_sectorsTagged);
+		return 1;
 	}
 	return 0;
 }
@@ -975,6 +1006,32 @@ static int lib_iterateLines(lua_State *L)
 	return 0;
 }
 
+// for line in lines.tagged(tag) do
+static int lib_iterateLinesTagged(lua_State *L)
+{
+	INT32 i = -1;
+	if (lua_gettop(L) < 2)
+		return luaL_error(L, "Don't call lines.tagged() iterators directly, use them as 'for line in lines.tagged(tag) do <block> end'.");
+	lua_settop(L, 2);
+	lua_remove(L, 1); // state is unused.
+	if (!lua_isnil(L, 1))
+		i = (INT32)(*((line_t **)luaL_checkudata(L, 1, META_LINE)) - lines);
+	i = P_FindLineFromTag((INT16)lua_tointeger(L, lua_upvalueindex(1)), i);
+	if (i >= 0)
+	{
+		LUA_PushUserdata(L, &lines[i], META_LINE);
+		return 1;
+	}
+	return 0;
+}
+
+static int lib_linesTagged(lua_State *L)
+{
+	lua_pushinteger(L, luaL_checkinteger(L, 1));
+	lua_pushcclosure(L, lib_iterateLinesTagged, 1);
+	return 1;
+}
+
 static int lib_getLine(lua_State *L)
 {
 	int field;
@@ -988,12 +1045,15 @@ static int lib_getLine(lua_State *L)
 		LUA_PushUserdata(L, &lines[i], META_LINE);
 		return 1;
 	}
-	field = luaL_checkoption(L, 1, NULL, array_opt);
+	field = luaL_checkoption(L, 1, NULL, tagged_array_opt);
 	switch(field)
 	{
 	case 0: // iterate
 		lua_pushcfunction(L, lib_iterateLines);
 		return 1;
+	case 1: // tagged
+		lua_pushcfunction(L, lib_linesTagged);
+		return 1;
 	}
 	return 0;
 }
@@ -34,6 +34,9 @@
 #include "lua_hook.h"
 
 #include "doomstat.h"
+#include "m_perfstats.h"
+#include "d_netcmd.h" // cv_luagcbudget
+#include "i_system.h" // I_GetPreciseTime
 
 lua_State *gL = NULL;
 
@@ -61,16 +64,182 @@ static lua_CFunction liblist[] = {
 	NULL
 };
 
+// -----------------
+// Lua memory pool
+// -----------------
+
+// Lua always says how big a block it frees or resizes was, so small blocks
+// need no header. They are carved from slabs of one size class each, in
+// steps of LUAPOOLGRAIN bytes, which keeps every block aligned for Lua.
+// Anything larger goes straight to malloc. Slabs are kept for the next
+// state when one is closed.
+#define LUAPOOLGRAIN 16
+#define LUAPOOLMAXSIZE 512
+#define NUMLUAPOOLCLASSES (LUAPOOLMAXSIZE / LUAPOOLGRAIN)
+#define LUAPOOLSLABBYTES (64<<10)
+
+#define LUAPOOLCLASS(size) (((size) - 1) / LUAPOOLGRAIN)
+#define LUAPOOLCLASSSIZE(c) (((c) + 1) * LUAPOOLGRAIN)
+
+typedef struct luapoolslab_s
+{
+	struct luapoolslab_s *next;
+	LUAI_USER_ALIGNMENT_T align; // keeps the slots after it aligned
+} luapoolslab_t;
+
+typedef struct
+{
+	void *freelist; // freed slots, chained through their first bytes
+	UINT8 *carve, *carveend; // untouched slots of the newest slab
+	size_t live; // blocks in use
+	size_t numslabs;
+	size_t allocs; // blocks ever handed out
+} luapoolclass_t;
+
+static luapoolclass_t luapool[NUMLUAPOOLCLASSES];
+static luapoolslab_t *luapoolslabs;
+static size_t luapoolusage; // bytes Lua asked for and holds now
+static size_t luabigusage, luabigblocks; // the malloc'd part of that
+
+static void *LUA_PoolAlloc(size_t size)
+{
+	luapoolclass_t *cls = &luapool[LUAPOOLCLASS(size)];
+	void *p;
+
+	if (cls->freelist)
+	{
+		p = cls->freelist;
+		cls->freelist = *(void **)p;
+	}
+	else
+	{
+		if (cls->carve == cls->carveend)
+		{
+			const size_t stride = LUAPOOLCLASSSIZE(cls - luapool);
+			luapoolslab_t *slab = malloc(sizeof (*slab) + LUAPOOLSLABBYTES);
+
+			if (slab == NULL)
+				I_Error("Out of memory allocating a Lua memory slab");
+
+			slab->next = luapoolslabs;
+			luapoolslabs = slab;
+			cls->numslabs++;
+
+			cls->carve = (UINT8 *)(slab + 1);
+			cls->carveend = cls->carve + (LUAPOOLSLABBYTES / stride) * stride;
+		}
+
+		p = cls->carve;
+		cls->carve += LUAPOOLCLASSSIZE(cls - luapool);
+	}
+
+	cls->live++;
+	cls->allocs++;
+	return p;
+}
+
+static void LUA_PoolFree(void *ptr, size_t size)
+{
+	luapoolclass_t *cls = &luapool[LUAPOOLCLASS(size)];
+
+	*(void **)ptr = cls->freelist;
+	cls->freelist = ptr;
+	cls->live--;
+}
+
 // Lua asks for memory using this.
 static void *LUA_Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
 {
+	void *p;
 	(void)ud;
-	if (nsize == 0) {
-		if (osize != 0)
-			Z_Free(ptr);
+
+	if (nsize == 0)
+	{
+		if (osize > LUAPOOLMAXSIZE)
+		{
+			free(ptr);
+			luabigusage -= osize;
+			luabigblocks--;
+		}
+		else if (osize != 0)
+			LUA_PoolFree(ptr, osize);
+
+		luapoolusage -= osize;
 		return NULL;
-	} else
-		return Z_Realloc(ptr, nsize, PU_LUA, NULL);
+	}
+
+	ps_lua_allocs.value.i++;
+
+	if (osize > LUAPOOLMAXSIZE && nsize > LUAPOOLMAXSIZE)
+	{
+		p = realloc(ptr, nsize);
+		if (p == NULL)
+			I_Error("Out of memory allocating %s bytes for Lua", sizeu1(nsize));
+		luabigusage += nsize - osize;
+		luapoolusage += nsize - osize;
+		return p;
+	}
+
+	if (nsize > LUAPOOLMAXSIZE)
+	{
+		p = malloc(nsize);
+		if (p == NULL)
+			I_Error("Out of memory allocating %s bytes for Lua", sizeu1(nsize));
+		luabigusage += nsize;
+		luabigblocks++;
+	}
+	else if (osize != 0 && LUAPOOLCLASS(osize) == LUAPOOLCLASS(nsize))
+		p = ptr; // still fits its slot
+	else
+		p = LUA_PoolAlloc(nsize);
+
+	if (p != ptr && osize != 0)
+	{
+		M_Memcpy(p, ptr, min(osize, nsize));
+
+		if (osize > LUAPOOLMAXSIZE)
+		{
+			free(ptr);
+			luabigusage -= osize;
+			luabigblocks--;
+		}
+		else
+			LUA_PoolFree(ptr, osize);
+	}
+
+	luapoolusage += nsize - osize;
+	return p;
+}
+
+size_t LUA_MemoryUsage(void)
+{
+	return luapoolusage;
+}
+
+// Prints how the Lua pool is used, and with classes, each size class in use.
+void LUA_PrintMemoryStats(boolean classes)
+{
+	size_t c, slabbytes = 0;
+
+	for (c = 0; c < NUMLUAPOOLCLASSES; c++)
+		slabbytes += luapool[c].numslabs * (sizeof (luapoolslab_t) + LUAPOOLSLABBYTES);
+
+	CONS_Printf(M_GetText("Lua pool slabs    : %7s KB\n"), sizeu1(slabbytes>>10));
+	CONS_Printf(M_GetText("Lua large blocks  : %7s KB (%s blocks)\n"), sizeu1(luabigusage>>10), sizeu2(luabigblocks));
+
+	if (!classes)
+		return;
+
+	for (c = 0; c < NUMLUAPOOLCLASSES; c++)
+	{
+		const luapoolclass_t *cls = &luapool[c];
+
+		if (!cls->numslabs)
+			continue;
+
+		CONS_Printf(" %4s bytes: %8s live, %3s slabs, %10s allocated\n",
+			sizeu1(LUAPOOLCLASSSIZE(c)), sizeu2(cls->live), sizeu3(cls->numslabs), sizeu4(cls->allocs));
+	}
 }
 
 // Panic function Lua calls when there's an unprotected error.
@@ -185,6 +354,51 @@ static int noglobals(lua_State *L)
 	return luaL_error(L, "Implicit global " LUA_QS " prevented. Create a local variable instead.", csname);
 }
 
+// Collector state kept by LUA_GCTic
+static boolean luagcstopped = false; // Lua's own collector is stopped
+static boolean luagcincycle = false; // a collection cycle is under way
+static INT32 luagclastkb = 0; // KB in use after the last tic's collection
+static INT32 luagcnextcycle = 0; // KB in use at which to start the next cycle
+static boolean luagcticked = false; // LUA_GCTic ran since the last LUA_Step
+
+// -----------------
+// Userdata cache
+// -----------------
+
+// Every userdata pushed to Lua, found by the pointer it wraps. The userdata
+// themselves are kept in the LREG_VALID table, at the index stored here, so
+// pushing one that already exists only takes two integer lookups, and a
+// pointer that was never pushed is turned away without calling into Lua.
+typedef struct
+{
+	void *data; // NULL if the slot is empty
+	const char *meta;
+	int ref; // index in LREG_VALID
+} luaudslot_t;
+
+static luaudslot_t *udslots = NULL; // open addressing, linear probing
+static size_t udcapacity = 0; // always a power of two
+static size_t udcount = 0;
+static int validref = LUA_NOREF; // LREG_VALID
+
+// Metatables, by the address of their name
+#define NUMMETAREFS 128
+static struct
+{
+	const char *meta;
+	int ref;
+} metarefs[NUMMETAREFS];
+static size_t nummetarefs = 0;
+
+static void LUA_ClearUserdataCache(void)
+{
+	Z_Free(udslots);
+	udslots = NULL;
+	udcapacity = udcount = 0;
+	validref = LUA_NOREF;
+	nummetarefs = 0;
+}
+
 // Clear and create a new Lua state, laddo!
 // There's SCRIPTIN to be had!
 void LUA_ClearState(void)
@@ -197,6 +411,10 @@ void LUA_ClearState(void)
 		lua_close(gL);
 	gL = NULL;
 
+	luagcstopped = luagcincycle = luagcticked = false;
+	luagclastkb = luagcnextcycle = 0;
+	LUA_ClearUserdataCache();
+
 	CONS_Printf(M_GetText("Pardon me while I initialize the Lua scripting interface...\n"));
 
 	// allocate state
@@ -209,6 +427,8 @@ void LUA_ClearState(void)
 
 	// make LREG_VALID table for all pushed userdata cache.
 	lua_newtable(L);
+	lua_pushvalue(L, -1);
+	validref = luaL_ref(L, LUA_REGISTRYINDEX);
 	lua_setfield(L, LUA_REGISTRYINDEX, LREG_VALID);
 
 	// open srb2 libraries
@@ -427,11 +647,114 @@ void LUA_InvalidateMathlibCache(const char *name)
 	lua_call(mL, 1, 0);
 }
 
+static inline size_t UD_Hash(const void *data)
+{
+	return (size_t)(((uintptr_t)data >> 3) * 0x9E3779B1u) & (udcapacity - 1);
+}
+
+static luaudslot_t *UD_Find(const void *data)
+{
+	size_t i;
+
+	if (!udcount)
+		return NULL;
+
+	for (i = UD_Hash(data); udslots[i].data; i = (i + 1) & (udcapacity - 1))
+		if (udslots[i].data == data)
+			return &udslots[i];
+
+	return NULL;
+}
+
+static void UD_Add(void *data, const char *meta, int ref)
+{
+	size_t i;
+
+	// Keep it at most half full
+	if ((udcount + 1) * 2 > udcapacity)
+	{
+		luaudslot_t *old = udslots;
+		size_t oldcapacity = udcapacity;
+
+		udcapacity = oldcapacity ? oldcapacity * 2 : 1024;
+		udslots = Z_Calloc(udcapacity * sizeof (*udslots), PU_LUA, NULL);
+
+		for (i = 0; i < oldcapacity; i++)
+		{
+			size_t j;
+
+			if (!old[i].data)
+				continue;
+
+			for (j = UD_Hash(old[i].data); udslots[j].data; j = (j + 1) & (udcapacity - 1))
+				;
+			udslots[j] = old[i];
+		}
+
+		Z_Free(old);
+	}
+
+	for (i = UD_Hash(data); udslots[i].data; i = (i + 1) & (udcapacity - 1))
+		;
+
+	udslots[i].data = data;
+	udslots[i].meta = meta;
+	udslots[i].ref = ref;
+	udcount++;
+}
+
+// Empties a slot, moving back whatever would become unreachable.
+static void UD_Remove(luaudslot_t *slot)
+{
+	const size_t mask = udcapacity - 1;
+	size_t i = slot - udslots, j = i, home;
+
+	for (;;)
+	{
+		j = (j + 1) & mask;
+		if (!udslots[j].data)
+			break;
+
+		// Leave it where it is if its home is still between the hole and it
+		home = UD_Hash(udslots[j].data);
+		if ((i <= j) ? (i < home && home <= j) : (i < home || home <= j))
+			continue;
+
+		udslots[i] = udslots[j];
+		i = j;
+	}
+
+	udslots[i].data = NULL;
+	udcount--;
+}
+
+static void LUA_PushMetatable(lua_State *L, const char *meta)
+{
+	size_t i;
+
+	for (i = 0; i < nummetarefs; i++)
+		if (metarefs[i].meta == meta)
+		{
+			lua_rawgeti(L, LUA_REGISTRYINDEX, metarefs[i].ref);
+			return;
+		}
+
+	luaL_getmetatable(L, meta);
+	if (nummetarefs < NUMMETAREFS && !lua_isnil(L, -1))
+	{
+		lua_pushvalue(L, -1);
+		metarefs[nummetarefs].meta = meta;
+		metarefs[nummetarefs].ref = luaL_ref(L, LUA_REGISTRYINDEX);
+		nummetarefs++;
+	}
+}
+
 // Takes a pointer, any pointer, and a metatable name
 // Creates a userdata for that pointer with the given metatable
 // Pushes it to the stack and stores it in the registry.
 void LUA_PushUserdata(lua_State *L, void *data, const char *meta)
 {
+	luaudslot_t *slot;
 	void **userdata;
 
 	if (!data) { // push a NULL
@@ -439,102 +762,138 @@ void LUA_PushUserdata(lua_State *L, void *data, const char *meta)
 		return;
 	}
 
-	lua_getfield(L, LUA_REGISTRYINDEX, LREG_VALID);
+	lua_rawgeti(L, LUA_REGISTRYINDEX, validref);
 	I_Assert(lua_istable(L, -1));
-	lua_pushlightuserdata(L, data);
-	lua_rawget(L, -2);
-	if (lua_isnil(L, -1)) { // no userdata? deary me, we'll have to make one.
-		lua_pop(L, 1); // pop the nil
 
-		// create the userdata
+	slot = UD_Find(data);
+	if (slot)
+		lua_rawgeti(L, -1, slot->ref);
+	else { // no userdata? deary me, we'll have to make one.
 		userdata = lua_newuserdata(L, sizeof(void *));
 		*userdata = data;
-		luaL_getmetatable(L, meta);
+		LUA_PushMetatable(L, meta);
 		lua_setmetatable(L, -2);
 
 		// Set it in the registry so we can find it again
-		lua_pushlightuserdata(L, data); // k (store the userdata via the data's pointer)
-		lua_pushvalue(L, -2); // v (copy of the userdata)
-		lua_rawset(L, -4);
+		lua_pushvalue(L, -1);
+		UD_Add(data, meta, luaL_ref(L, -3));
 
 		// stack is left with the userdata on top, as if getting it had originally succeeded.
 	}
 	lua_remove(L, -2); // remove LREG_VALID
 }
 
+// Expects LREG_EXTVARS and LREG_VALID on top of the stack, in that order.
+static void UD_Invalidate(luaudslot_t *slot)
+{
+	void **userdata;
+
+	// nullify any additional data
+	lua_pushlightuserdata(gL, slot->data);
+	lua_pushnil(gL);
+	lua_rawset(gL, -4);
+
+	// invalidate the userdata
+	lua_rawgeti(gL, -1, slot->ref);
+	userdata = lua_touserdata(gL, -1);
+	*userdata = NULL;
+	lua_pop(gL, 1);
+
+	// remove it from the registry
+	luaL_unref(gL, -1, slot->ref);
+	UD_Remove(slot);
+}
+
 // When userdata is freed, use this function to remove it from Lua.
 void LUA_InvalidateUserdata(void *data)
 {
-	void **userdata;
+	luaudslot_t *slot;
 	if (!gL)
 		return;
 
-	// fetch the userdata
-	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_VALID);
+	slot = UD_Find(data);
+	if (!slot) // not found, not in lua
+		return;
+
+	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_EXTVARS);
 	I_Assert(lua_istable(gL, -1));
-		lua_pushlightuserdata(gL, data);
-		lua_rawget(gL, -2);
-			if (lua_isnil(gL, -1)) { // not found, not in lua
-				lua_pop(gL, 2); // pop nil and LREG_VALID
-				return;
-			}
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, validref);
+	I_Assert(lua_istable(gL, -1));
+		UD_Invalidate(slot);
+	lua_pop(gL, 2); // pop LREG_VALID and LREG_EXTVARS
+}
 
-			// nullify any additional data
-			lua_getfield(gL, LUA_REGISTRYINDEX, LREG_EXTVARS);
-			I_Assert(lua_istable(gL, -1));
-				lua_pushlightuserdata(gL, data);
-				lua_pushnil(gL);
-				lua_rawset(gL, -3);
-			lua_pop(gL, 1);
+// Invalidate every userdata the predicate picks, visiting only live ones.
+static void UD_InvalidateMatching(boolean (*dead)(void *, const char *))
+{
+	size_t i = 0;
+	if (!gL || !udcount)
+		return;
 
-			// invalidate the userdata
-			userdata = lua_touserdata(gL, -1);
-			*userdata = NULL;
-		lua_pop(gL, 1);
+	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_EXTVARS);
+	I_Assert(lua_istable(gL, -1));
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, validref);
+	I_Assert(lua_istable(gL, -1));
+		while (i < udcapacity)
+		{
+			// Removing moves a later slot into this one, so look at it again
+			if (udslots[i].data && dead(udslots[i].data, udslots[i].meta))
+				UD_Invalidate(&udslots[i]);
+			else
+				i++;
+		}
+	lua_pop(gL, 2); // pop LREG_VALID and LREG_EXTVARS
+}
 
-		// remove it from the registry
-		lua_pushlightuserdata(gL, data);
-		lua_pushnil(gL);
-		lua_rawset(gL, -3);
-	lua_pop(gL, 1); // pop LREG_VALID
+static boolean (*deadpredicate)(void *);
+
+static boolean UD_PredicateDead(void *data, const char *meta)
+{
+	(void)meta;
+	return deadpredicate(data);
 }
 
-// Invalidate level data arrays
-void LUA_InvalidateLevel(void)
+// Invalidate every userdata whose pointer the predicate reports as freed.
+// Costs one call per live userdata, instead of one lookup per freed block.
+void LUA_InvalidateUserdataIf(boolean (*dead)(void *))
 {
-	thinker_t *th;
-	size_t i;
-	if (!gL)
-		return;
+	deadpredicate = dead;
+	UD_InvalidateMatching(UD_PredicateDead);
+	deadpredicate = NULL;
+}
 
-	for (th = thinkercap.next; th && th != &thinkercap; th = th->next)
-		LUA_InvalidateUserdata(th);
+#define UD_INARRAY(data, array, count) \
+	((const UINT8 *)(data) >= (const UINT8 *)(array) && (const UINT8 *)(data) < (const UINT8 *)((array) + (count)))
 
-	LUA_InvalidateMapthings();
+static boolean UD_MapthingData(void *data, const char *meta)
+{
+	(void)meta;
+	return UD_INARRAY(data, mapthings, nummapthings);
+}
 
-	for (i = 0; i < numsubsectors; i++)
-		LUA_InvalidateUserdata(&subsectors[i]);
-	for (i = 0; i < numsectors; i++)
-		LUA_InvalidateUserdata(&sectors[i]);
-	for (i = 0; i < numlines; i++)
-	{
-		LUA_InvalidateUserdata(&lines[i]);
-		LUA_InvalidateUserdata(lines[i].sidenum);
-	}
-	for (i = 0; i < numsides; i++)
-		LUA_InvalidateUserdata(&sides[i]);
-	for (i = 0; i < numvertexes; i++)
-		LUA_InvalidateUserdata(&vertexes[i]);
+// Line sidenums live inside their line, so the lines check covers them
+static boolean UD_LevelData(void *data, const char *meta)
+{
+	return (fastcmp(meta, META_MOBJ) // every live mobj is a level thinker
+		|| UD_INARRAY(data, mapthings, nummapthings)
+		|| UD_INARRAY(data, subsectors, numsubsectors)
+		|| UD_INARRAY(data, sectors, numsectors)
+		|| UD_INARRAY(data, lines, numlines)
+		|| UD_INARRAY(data, sides, numsides)
+		|| UD_INARRAY(data, vertexes, numvertexes));
 }
 
-void LUA_InvalidateMapthings(void)
+#undef UD_INARRAY
+
+// Invalidate level data arrays
+void LUA_InvalidateLevel(void)
 {
-	size_t i;
-	if (!gL)
-		return;
+	UD_InvalidateMatching(UD_LevelData);
+}
 
-	for (i = 0; i < nummapthings; i++)
-		LUA_InvalidateUserdata(&mapthings[i]);
+void LUA_InvalidateMapthings(void)
+{
+	UD_InvalidateMatching(UD_MapthingData);
 }
 
 void LUA_InvalidatePlayer(player_t *player)
@@ -568,6 +927,8 @@ enum
 	ARCH_SLOPE,
 	ARCH_MAPHEADER,
 
+	ARCH_STRINGREF, // network only, a string already written
+
 	ARCH_TEND=0xFF,
 };
 
@@ -610,6 +971,176 @@ static UINT8 GetUserdataArchType(int index)
 	return ARCH_NULL;
 }
 
+// Network archives are compact: numbers, lengths and table ids are
+// varints, and a string written before is sent again as its id. Demos keep
+// the fixed-size format so old replays still load.
+static boolean archcompact = false;
+
+// Tables and strings already written, found by address, so that archiving
+// never searches what it wrote before. Lua interns strings, so one address
+// is one string. Both are kept alive in the tables table until the end.
+typedef struct
+{
+	const void *key; // NULL if the slot is empty
+	UINT32 id;
+} archslot_t;
+
+typedef struct
+{
+	archslot_t *slots;
+	size_t capacity; // always a power of two
+	size_t count;
+} archmap_t;
+
+static archmap_t archtables, archstrings;
+static UINT32 archnumstrings; // strings read so far
+static UINT8 *archend; // end of the network archive being read
+static boolean archcorrupt; // stop reading, the save is broken
+
+static inline size_t ArchMap_Hash(const archmap_t *map, const void *key)
+{
+	return (size_t)(((uintptr_t)key >> 3) * 0x9E3779B1u) & (map->capacity - 1);
+}
+
+static UINT32 ArchMap_Find(const archmap_t *map, const void *key)
+{
+	size_t i;
+
+	if (!map->count)
+		return 0;
+
+	for (i = ArchMap_Hash(map, key); map->slots[i].key; i = (i + 1) & (map->capacity - 1))
+		if (map->slots[i].key == key)
+			return map->slots[i].id;
+
+	return 0;
+}
+
+static void ArchMap_Add(archmap_t *map, const void *key, UINT32 id)
+{
+	size_t i;
+
+	// Keep it at most half full
+	if ((map->count + 1) * 2 > map->capacity)
+	{
+		archslot_t *old = map->slots;
+		size_t oldcapacity = map->capacity;
+
+		map->capacity = oldcapacity ? oldcapacity * 2 : 256;
+		map->slots = Z_Calloc(map->capacity * sizeof (*map->slots), PU_LUA, NULL);
+
+		for (i = 0; i < oldcapacity; i++)
+		{
+			size_t j;
+
+			if (!old[i].key)
+				continue;
+
+			for (j = ArchMap_Hash(map, old[i].key); map->slots[j].key; j = (j + 1) & (map->capacity - 1))
+				;
+			map->slots[j] = old[i];
+		}
+
+		Z_Free(old);
+	}
+
+	for (i = ArchMap_Hash(map, key); map->slots[i].key; i = (i + 1) & (map->capacity - 1))
+		;
+
+	map->slots[i].key = key;
+	map->slots[i].id = id;
+	map->count++;
+}
+
+static void ArchMap_Clear(archmap_t *map)
+{
+	Z_Free(map->slots);
+	map->slots = NULL;
+	map->capacity = map->count = 0;
+}
+
+static void WriteVarint(UINT8 **p, UINT32 value)
+{
+	while (value >= 0x80)
+	{
+		WRITEUINT8(*p, (UINT8)(value | 0x80));
+		value >>= 7;
+	}
+	WRITEUINT8(*p, (UINT8)value);
+}
+
+static UINT32 ReadVarint(UINT8 **p)
+{
+	UINT32 value = 0;
+	UINT8 shift = 0, byte;
+
+	do
+	{
+		byte = READUINT8(*p);
+		value |= (UINT32)(byte & 0x7F) << shift;
+		shift += 7;
+	} while ((byte & 0x80) && shift < 32);
+
+	return value;
+}
+
+// Zigzag, so small negative numbers stay short too
+static void WriteSignedVarint(UINT8 **p, INT32 value)
+{
+	WriteVarint(p, ((UINT32)value << 1) ^ (UINT32)(value >> 31));
+}
+
+static INT32 ReadSignedVarint(UINT8 **p)
+{
+	UINT32 value = ReadVarint(p);
+	return (INT32)((value >> 1) ^ (0u - (value & 1)));
+}
+
+// Strings are written whole the first time, then by id.
+static void ArchiveString(UINT8 **p, int TABLESINDEX, int myindex)
+{
+	size_t len;
+	const char *s = lua_tolstring(gL, myindex, &len);
+	UINT32 id;
+
+	if (!archcompact)
+	{
+		UINT16 i = 0;
+		WRITEUINT8(*p, ARCH_STRING);
+		// if you're wondering why we're writing a string to save_p this way,
+		// it turns out that Lua can have embedded zeros ('\0') in the strings,
+		// so we can't use WRITESTRING as that cuts off when it finds a '\0'.
+		// Saving the size of the string also allows us to get the size of the string on the other end,
+		// fixing the awful crashes previously encountered for reading strings longer than 1024
+		// (yes I know that's kind of a stupid thing to care about, but it'd be evil to trim or ignore them?)
+		// -- Monster Iestyn 05/08/18
+		WRITEUINT16(*p, (UINT16)len); // save size of string
+		while (i < (UINT16)len)
+			WRITECHAR(*p, s[i++]); // write chars individually, including the embedded zeros
+		return;
+	}
+
+	id = ArchMap_Find(&archstrings, s);
+	if (id)
+	{
+		WRITEUINT8(*p, ARCH_STRINGREF);
+		WriteVarint(p, id);
+		return;
+	}
+
+	id = (UINT32)archstrings.count + 1;
+	ArchMap_Add(&archstrings, s, id);
+
+	// Keep it alive so its address can't be reused by another string
+	lua_pushvalue(gL, myindex);
+	lua_rawseti(gL, TABLESINDEX, -(int)id);
+
+	WRITEUINT8(*p, ARCH_STRING);
+	WriteVarint(p, (UINT32)len);
+	M_Memcpy(*p, s, len);
+	*p += len;
+}
+
 static UINT8 ArchiveValue(UINT8 **p, int TABLESINDEX, int myindex)
 {
 	if (myindex < 0)
@@ -634,62 +1165,45 @@ static UINT8 ArchiveValue(UINT8 **p, int TABLESINDEX, int myindex)
 	{
 		lua_Integer number = lua_tointeger(gL, myindex);
         WRITEUINT8(*p, ARCH_SIGNED);
-        WRITEFIXED(*p, number);
+		if (archcompact)
+			WriteSignedVarint(p, (INT32)number);
+		else
+			WRITEFIXED(*p, number);
 		break;
 	}
 	case LUA_TSTRING:
-	{
-		UINT16 len = (UINT16)lua_objlen(gL, myindex); // get length of string, including embedded zeros
-		const char *s = lua_tostring(gL, myindex);
-		UINT16 i = 0;
-		WRITEUINT8(*p, ARCH_STRING);
-		// if you're wondering why we're writing a string to save_p this way,
-		// it turns out that Lua can have embedded zeros ('\0') in the strings,
-		// so we can't use WRITESTRING as that cuts off when it finds a '\0'.
-		// Saving the size of the string also allows us to get the size of the string on the other end,
-		// fixing the awful crashes previously encountered for reading strings longer than 1024
-		// (yes I know that's kind of a stupid thing to care about, but it'd be evil to trim or ignore them?)
-		// -- Monster Iestyn 05/08/18
-		WRITEUINT16(*p, len); // save size of string
-		while (i < len)
-			WRITECHAR(*p, s[i++]); // write chars individually, including the embedded zeros
+		ArchiveString(p, TABLESINDEX, myindex);
 		break;
-	}
 	case LUA_TTABLE:
 	{
-		boolean found = false;
-		INT32 i;
-		UINT16 t = (UINT16)lua_objlen(gL, TABLESINDEX);
+		const void *table = lua_topointer(gL, myindex);
+		UINT32 t = ArchMap_Find(&archtables, table);
+		boolean found = (t != 0);
 
-		for (i = 1; i <= t && !found; i++)
-		{
-			lua_rawgeti(gL, TABLESINDEX, i);
-			if (lua_rawequal(gL, myindex, -1))
-			{
-				t = i;
-				found = true;
-			}
-			lua_pop(gL, 1);
-		}
 		if (!found)
 		{
-			t++;
+			t = (UINT32)archtables.count + 1;
 
-			if (t == 0)
+			if (t > UINT16_MAX)
 			{
 				CONS_Alert(CONS_ERROR, "Too many tables to archive!\n");
 				WRITEUINT8(*p, ARCH_NULL);
 				return 0;
 			}
+
+			ArchMap_Add(&archtables, table, t);
 		}
 
 		WRITEUINT8(*p, ARCH_TABLE);
-		WRITEUINT16(*p, t);
+		if (archcompact)
+			WriteVarint(p, t);
+		else
+			WRITEUINT16(*p, (UINT16)t);
 
 		if (!found)
 		{
 			lua_pushvalue(gL, myindex);
-			lua_rawseti(gL, TABLESINDEX, t);
+			lua_rawseti(gL, TABLESINDEX, (int)t);
 			return 1;
 		}
 		break;
@@ -877,7 +1391,10 @@ static void ArchiveExtVars(UINT8 **p, void *pointer, const char *ptype)
 	while (lua_next(gL, -2))
 	{
 		I_Assert(lua_type(gL, -2) == LUA_TSTRING);
-		WRITESTRING(*p, lua_tostring(gL, -2));
+		if (archcompact)
+			ArchiveString(p, TABLESINDEX, -2);
+		else
+			WRITESTRING(*p, lua_tostring(gL, -2));
 		if (ArchiveValue(p, TABLESINDEX, -1) == 2)
 			CONS_Alert(CONS_ERROR, "Type of value for %s entry '%s' (%s) could not be archived!\n", ptype, lua_tostring(gL, -2), luaL_typename(gL, -1));
 		lua_pop(gL, 1);
@@ -940,9 +1457,31 @@ static void ArchiveTables(UINT8 **p)
 	}
 }
 
+static void UnArchiveCorrupted(void)
+{
+	if (archcorrupt)
+		return;
+
+	archcorrupt = true;
+	CONS_Alert(CONS_ERROR, "Lua archive data runs past the end of the save, save is corrupted!\n");
+	G_SetExitGameFlag();
+	S_StartSound(NULL, sfx_syfail);
+	M_StartMessage(M_GetText("Corrupted save received\nPress ESC\n"), NULL, MM_NOTHING);
+}
+
+// Network archives only, see ArchiveValue for the format
 static UINT8 UnArchiveValue(UINT8 **p, int TABLESINDEX)
 {
-	UINT8 type = READUINT8(*p);
+	UINT8 type;
+
+	// Anything after a bad length would be read from the wrong place
+	if (archcorrupt)
+	{
+		lua_pushnil(gL);
+		return 0;
+	}
+
+	type = READUINT8(*p);
 	switch (type)
 	{
 	case ARCH_NULL:
@@ -952,35 +1491,40 @@ static UINT8 UnArchiveValue(UINT8 **p, int TABLESINDEX)
 		lua_pushboolean(gL, READUINT8(*p));
 		break;
 	case ARCH_SIGNED:
-		lua_pushinteger(gL, READFIXED(*p));
+		lua_pushinteger(gL, ReadSignedVarint(p));
 		break;
 	case ARCH_STRING:
 	{
-		UINT16 len = READUINT16(*p); // length of string, including embedded zeros
-		char *value;
-		UINT16 i = 0;
-		// See my comments in the ArchiveValue function;
-		// it's much the same for reading strings as writing them!
-		// (i.e. we can't use READSTRING either)
-		// -- Monster Iestyn 05/08/18
-		value = malloc(len); // make temp buffer of size len
-		// now read the actual string
-		while (i < len)
-			value[i++] = READCHAR(*p); // read chars individually, including the embedded zeros
-		lua_pushlstring(gL, value, len); // push the string (note: this function supports embedded zeros)
-		free(value); // free the buffer
+		UINT32 len = ReadVarint(p); // length of string, including embedded zeros
+
+		if (*p > archend || len > (size_t)(archend - *p))
+		{
+			UnArchiveCorrupted();
+			lua_pushnil(gL);
+			break;
+		}
+
+		lua_pushlstring(gL, (const char *)*p, len); // push the string (note: this function supports embedded zeros)
+		*p += len;
+
+		// Later copies only send its id
+		lua_pushvalue(gL, -1);
+		lua_rawseti(gL, TABLESINDEX, -(int)++archnumstrings);
 		break;
 	}
+	case ARCH_STRINGREF:
+		lua_rawgeti(gL, TABLESINDEX, -(int)ReadVarint(p));
+		break;
 	case ARCH_TABLE:
 	{
-		UINT16 tid = READUINT16(*p);
-		lua_rawgeti(gL, TABLESINDEX, tid);
+		UINT32 tid = ReadVarint(p);
+		lua_rawgeti(gL, TABLESINDEX, (int)tid);
 		if (lua_isnil(gL, -1))
 		{
 			lua_pop(gL, 1);
 			lua_newtable(gL);
 			lua_pushvalue(gL, -1);
-			lua_rawseti(gL, TABLESINDEX, tid);
+			lua_rawseti(gL, TABLESINDEX, (int)tid);
 			return 2;
 		}
 		break;
@@ -1154,11 +1698,17 @@ static void UnArchiveExtVars(UINT8 **p, void *pointer, boolean network)
 
 	if (network)
 	{
-		for (i = 0; i < field_count; i++)
+		for (i = 0; i < field_count && !archcorrupt; i++)
 		{
-			READSTRING(*p, field);
+			UnArchiveValue(p, TABLESINDEX); // field name
 			UnArchiveValue(p, TABLESINDEX);
-			lua_setfield(gL, -2, field);
+			if (lua_type(gL, -2) != LUA_TSTRING)
+			{
+				CONS_Alert(CONS_ERROR, "A field name that isn't a string was found! (Corrupted save?)\n");
+				lua_pop(gL, 2);
+			}
+			else
+				lua_rawset(gL, -3);
 		}
 	}
 	else
@@ -1206,7 +1756,7 @@ static void UnArchiveTables(UINT8 **p, boolean network)
 		for (i = 1; i <= n; i++)
 		{
 			lua_rawgeti(gL, TABLESINDEX, i);
-			while (true)
+			while (!archcorrupt)
 			{
 				if (UnArchiveValue(p, TABLESINDEX) == 1) // read key
 					break;
@@ -1268,8 +1818,94 @@ void LUA_Step(void)
 	{
 		CONS_Alert(CONS_WARNING, "Eek, there is garbage on lua stack!\n");
 		lua_settop(gL, 0);
-		lua_gc(gL, LUA_GCSTEP, 1);
+		// A step would restart a collector the budget keeps stopped,
+		// which collects within the budget below anyway
+		if (!luagcstopped)
+			lua_gc(gL, LUA_GCSTEP, 1);
 	}
+
+	// P_Ticker doesn't run outside of levels or while paused, but HUD,
+	// intermission and vote hooks still allocate, so collect here then.
+	if (!luagcticked)
+		LUA_GCTic();
+	luagcticked = false;
+}
+
+// Runs the collector after a tic, or from LUA_Step after a frame that
+// ran none, for up to cv_luagcbudget microseconds.
+// With a budget, Lua's own collector is kept stopped, so collection no
+// longer happens whenever an allocation in the middle of a hook crosses
+// its threshold.
+void LUA_GCTic(void)
+{
+	precise_t limit;
+	INT32 kb, allocated;
+
+	ps_lua_gc_time.value.p = 0;
+
+	if (!gL)
+		return;
+
+	luagcticked = true;
+
+	if (!cv_luagcbudget.value)
+	{
+		if (luagcstopped)
+		{
+			lua_gc(gL, LUA_GCRESTART, 0);
+			luagcstopped = false;
+			luagcincycle = false;
+			luagcnextcycle = 0;
+		}
+		ps_lua_gc_pause.value.i = 0;
+		return;
+	}
+
+	luagcstopped = true;
+	kb = lua_gc(gL, LUA_GCCOUNT, 0);
+	allocated = max(kb - luagclastkb, 0);
+
+	// Lua's own pause: wait for memory to double after a cycle
+	if (!luagcincycle && kb < luagcnextcycle)
+	{
+		lua_gc(gL, LUA_GCSTOP, 0);
+		luagclastkb = kb;
+		ps_lua_gc_pause.value.i = luagcnextcycle;
+		return;
+	}
+
+	luagcincycle = true;
+
+	PS_START_TIMING(ps_lua_gc_time);
+	limit = ps_lua_gc_time.value.p + (precise_t)cv_luagcbudget.value * I_GetPrecisePrecision() / 1000000;
+
+	for (;;)
+	{
+		if (lua_gc(gL, LUA_GCSTEP, 0))
+		{
+			luagcincycle = false;
+			break;
+		}
+
+		if (I_GetPreciseTime() >= limit)
+		{
+			// Out of time. Still do at least the work Lua would have done
+			// itself for what was allocated since the last tic, so memory
+			// can't run away from a budget that is too small.
+			if (lua_gc(gL, LUA_GCSTEP, allocated))
+				luagcincycle = false;
+			break;
+		}
+	}
+
+	lua_gc(gL, LUA_GCSTOP, 0);
+	PS_STOP_TIMING(ps_lua_gc_time);
+
+	luagclastkb = lua_gc(gL, LUA_GCCOUNT, 0);
+	if (!luagcincycle)
+		luagcnextcycle = luagclastkb * 2;
+
+	ps_lua_gc_pause.value.i = luagcincycle ? 0 : luagcnextcycle;
 }
 
 void LUA_Archive(savebuffer_t *save, boolean network)
@@ -1280,6 +1916,8 @@ void LUA_Archive(savebuffer_t *save, boolean network)
 	if (gL)
 		lua_newtable(gL); // tables to be archived.
 
+	archcompact = network;
+
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
 		if (!playeringame[i] && i > 0)	// NEVER skip player 0, this is for dedi servs.
@@ -1292,7 +1930,7 @@ void LUA_Archive(savebuffer_t *save, boolean network)
 	{
 		if (gamestate == GS_LEVEL)
 		{
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 			{
 				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 					continue;
@@ -1311,6 +1949,10 @@ void LUA_Archive(savebuffer_t *save, boolean network)
 
 	if (gL)
 		lua_pop(gL, 1); // pop tables
+
+	ArchMap_Clear(&archtables);
+	ArchMap_Clear(&archstrings);
+	archcompact = false;
 }
 
 void LUA_UnArchive(savebuffer_t *save, boolean network)
@@ -1322,6 +1964,10 @@ void LUA_UnArchive(savebuffer_t *save, boolean network)
 	if (gL)
 		lua_newtable(gL); // tables to be read
 
+	archnumstrings = 0;
+	archend = save->end;
+	archcorrupt = false;
+
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
 		if (!playeringame[i] && i > 0)	// same here, this is to synch dediservs properly.
@@ -1334,7 +1980,7 @@ void LUA_UnArchive(savebuffer_t *save, boolean network)
 	{
 		do {
 			mobjnum = READUINT32(save->p); // read a mobjnum
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 			{
 				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 					continue;
@@ -1342,7 +1988,7 @@ void LUA_UnArchive(savebuffer_t *save, boolean network)
 				if (((mobj_t *)th)->mobjnum == mobjnum) // find matching mobj
 					UnArchiveExtVars(&save->p, th, network); // apply variables
 			}
-		} while(mobjnum != UINT32_MAX); // repeat until end of mobjs marker.
+		} while(mobjnum != UINT32_MAX && !archcorrupt); // repeat until end of mobjs marker.
 
 		LUAh_NetArchiveHook(NetUnArchive, save); // call the NetArchive hook in unarchive mode
 	}
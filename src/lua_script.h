@@ -39,6 +39,9 @@ void LUA_ClearExtVars(void);
 
 void LUA_ClearState(void);
 
+size_t LUA_MemoryUsage(void);
+void LUA_PrintMemoryStats(boolean classes);
+
 int LUA_GetErrorMessage(lua_State *L);
 int LUA_Call(lua_State *L, int nargs, int nresults, int errorhandlerindex);
 void LUA_LoadLump(UINT16 wad, UINT16 lump);
@@ -52,10 +55,12 @@ void LUA_InvalidateMathlibCache(const char *name);
 
 void LUA_PushUserdata(lua_State *L, void *data, const char *meta);
 void LUA_InvalidateUserdata(void *data);
+void LUA_InvalidateUserdataIf(boolean (*dead)(void *));
 void LUA_InvalidateLevel(void);
 void LUA_InvalidateMapthings(void);
 void LUA_InvalidatePlayer(player_t *player);
 void LUA_Step(void);
+void LUA_GCTic(void);
 void LUA_Archive(savebuffer_t *save, boolean network);
 void LUA_UnArchive(savebuffer_t *save, boolean network);
 
@@ -27,8 +27,15 @@ static const actionf_p1 iter_funcs[] = {
 	(actionf_p1)P_MobjThinker
 };
 
+// Which thinker lists each option walks through
+static const thinklistnum_t iter_lists[][2] = {
+	{0, NUM_THINKERLISTS-1},
+	{THINK_MOBJ, THINK_MOBJ}
+};
+
 struct iterationState {
 	actionf_p1 filter;
+	thinklistnum_t first, last;
 	int next;
 };
 
@@ -57,7 +64,7 @@ static int lib_iterateThinkers(lua_State *L)
 	lua_settop(L, 2);
 
 	if (lua_isnil(L, 2))
-		th = &thinkercap;
+		th = &thlist[it->first];
 	else if (lua_isuserdata(L, 2))
 	{
 		if (lua_islightuserdata(L, 2))
@@ -83,17 +90,22 @@ static int lib_iterateThinkers(lua_State *L)
 	it->next = LUA_REFNIL;
 
 	if (th && !next)
-		next = th->next;
-	if (!next)
+	{
+		if (!th->next)
+			return luaL_error(L, "next thinker invalidated during iteration");
+		next = P_NextThinker(th, it->last);
+	}
+	else if (!next)
 		return luaL_error(L, "next thinker invalidated during iteration");
 
-	for (; next != &thinkercap; next = next->next)
+	for (; next; next = P_NextThinker(next, it->last))
 		if (!it->filter || next->function.acp1 == it->filter)
 		{
+			thinker_t *after = P_NextThinker(next, it->last);
 			push_thinker(next);
-			if (next->next != &thinkercap)
+			if (after)
 			{
-				push_thinker(next->next);
+				push_thinker(after);
 				it->next = luaL_ref(L, LUA_REGISTRYINDEX);
 			}
 			return 1;
@@ -104,13 +116,17 @@ static int lib_iterateThinkers(lua_State *L)
 static int lib_startIterate(lua_State *L)
 {
 	struct iterationState *it;
+	int option;
 
 	lua_pushvalue(L, lua_upvalueindex(1));
 	it = lua_newuserdata(L, sizeof(struct iterationState));
 	luaL_getmetatable(L, META_ITERATIONSTATE);
 	lua_setmetatable(L, -2);
 
-	it->filter = iter_funcs[luaL_checkoption(L, 1, "mobj", iter_opt)];
+	option = luaL_checkoption(L, 1, "mobj", iter_opt);
+	it->filter = iter_funcs[option];
+	it->first = iter_lists[option][0];
+	it->last = iter_lists[option][1];
 	it->next = LUA_REFNIL;
 	return 2;
 }
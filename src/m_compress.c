@@ -0,0 +1,320 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2023 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_compress.c
+/// \brief Interchangeable compression codecs for network transfers
+///
+///        LZF is what older versions use. LZ4 is compatible with the
+///        reference block format (no frames), and Deflate is plain zlib.
+
+#ifdef HAVE_ZLIB
+#ifndef _MSC_VER
+#ifndef _LARGEFILE64_SOURCE
+#define _LARGEFILE64_SOURCE
+#endif
+#endif
+
+#ifndef _LFS64_LARGEFILE
+#define _LFS64_LARGEFILE
+#endif
+
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 0
+#endif
+
+#include "zlib.h"
+#endif
+
+#include "doomdef.h"
+#include "i_system.h"
+#include "lzf.h"
+#include "m_compress.h"
+
+// =========================================================================
+//                                   LZ4
+// =========================================================================
+
+#define LZ4_MINMATCH 4
+#define LZ4_LASTLITERALS 5 // the last bytes are always literals
+#define LZ4_MFLIMIT 12 // no match may start this close to the end
+#define LZ4_MAXOFFSET 65535
+#define LZ4_HASHLOG 12
+
+static inline UINT32 LZ4_Read32(const UINT8 *p)
+{
+	UINT32 v;
+	memcpy(&v, p, sizeof v);
+	return v;
+}
+
+static inline UINT32 LZ4_Hash(UINT32 sequence)
+{
+	return (sequence * 2654435761u) >> (32 - LZ4_HASHLOG);
+}
+
+// Writes the bytes that follow a token for a length of 15 or more.
+static UINT8 *LZ4_WriteLength(UINT8 *op, size_t len)
+{
+	for (; len >= 255; len -= 255)
+		*op++ = 255;
+	*op++ = (UINT8)len;
+	return op;
+}
+
+static size_t LZ4_Compress(const UINT8 *src, size_t srclen, UINT8 *dest, size_t destlen)
+{
+	UINT32 table[1<<LZ4_HASHLOG]; // where each sequence hash was last seen
+	const UINT8 *ip = src, *anchor = src, *iend = src + srclen;
+	const UINT8 *matchlimit = iend - LZ4_LASTLITERALS;
+	UINT8 *op = dest, *oend = dest + destlen;
+	size_t litlen;
+
+	memset(table, 0, sizeof table);
+
+	if (srclen > LZ4_MFLIMIT)
+	{
+		const UINT8 *mflimit = iend - LZ4_MFLIMIT;
+
+		while (ip < mflimit)
+		{
+			UINT32 sequence = LZ4_Read32(ip);
+			UINT32 *entry = &table[LZ4_Hash(sequence)];
+			const UINT8 *ref = src + *entry;
+			size_t matchlen;
+
+			*entry = (UINT32)(ip - src);
+			if (ref >= ip || ip - ref > LZ4_MAXOFFSET || LZ4_Read32(ref) != sequence)
+			{
+				ip++;
+				continue;
+			}
+
+			while (ip > anchor && ref > src && ip[-1] == ref[-1])
+				ip--, ref--;
+			for (matchlen = LZ4_MINMATCH; ip + matchlen < matchlimit && ip[matchlen] == ref[matchlen]; matchlen++)
+				;
+
+			litlen = ip - anchor;
+			if ((size_t)(oend - op) < 1 + litlen/255 + 1 + litlen + 2 + matchlen/255 + 1)
+				return 0;
+
+			*op = (UINT8)(min(litlen, 15)<<4 | min(matchlen - LZ4_MINMATCH, 15));
+			op++;
+			if (litlen >= 15)
+				op = LZ4_WriteLength(op, litlen - 15);
+			memcpy(op, anchor, litlen);
+			op += litlen;
+			*op++ = (UINT8)(ip - ref);
+			*op++ = (UINT8)((ip - ref)>>8);
+			if (matchlen - LZ4_MINMATCH >= 15)
+				op = LZ4_WriteLength(op, matchlen - LZ4_MINMATCH - 15);
+
+			ip = anchor = ip + matchlen;
+		}
+	}
+
+	litlen = iend - anchor;
+	if ((size_t)(oend - op) < 1 + litlen/255 + 1 + litlen)
+		return 0;
+	*op++ = (UINT8)(min(litlen, 15)<<4);
+	if (litlen >= 15)
+		op = LZ4_WriteLength(op, litlen - 15);
+	memcpy(op, anchor, litlen);
+	op += litlen;
+
+	return op - dest;
+}
+
+// Reads the bytes that follow a token for a length of 15 or more.
+// Returns false if they run past the end.
+static boolean LZ4_ReadLength(const UINT8 **ip, const UINT8 *iend, size_t *len)
+{
+	UINT8 b;
+	do
+	{
+		if (*ip >= iend)
+			return false;
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255);
+	return true;
+}
+
+static size_t LZ4_Decompress(const UINT8 *src, size_t srclen, UINT8 *dest, size_t destlen)
+{
+	const UINT8 *ip = src, *iend = src + srclen;
+	UINT8 *op = dest, *oend = dest + destlen;
+
+	while (ip < iend)
+	{
+		UINT8 token = *ip++;
+		size_t litlen = token>>4, matchlen = token & 15, offset;
+
+		if (litlen == 15 && !LZ4_ReadLength(&ip, iend, &litlen))
+			return 0;
+		if (litlen > (size_t)(iend - ip) || litlen > (size_t)(oend - op))
+			return 0;
+		memcpy(op, ip, litlen);
+		op += litlen;
+		ip += litlen;
+
+		if (ip == iend) // the last sequence has no match
+			break;
+
+		if (iend - ip < 2)
+			return 0;
+		offset = ip[0] | (ip[1]<<8);
+		ip += 2;
+		if (!offset || offset > (size_t)(op - dest))
+			return 0;
+
+		if (matchlen == 15 && !LZ4_ReadLength(&ip, iend, &matchlen))
+			return 0;
+		matchlen += LZ4_MINMATCH;
+		if (matchlen > (size_t)(oend - op))
+			return 0;
+
+		if (offset >= matchlen)
+			memcpy(op, op - offset, matchlen);
+		else
+		{
+			// Overlapping copy, which repeats the last offset bytes.
+			const UINT8 *ref = op - offset;
+			size_t i;
+			for (i = 0; i < matchlen; i++)
+				op[i] = ref[i];
+		}
+		op += matchlen;
+	}
+
+	return op - dest;
+}
+
+// =========================================================================
+//                                 CODECS
+// =========================================================================
+
+UINT8 M_SupportedCodecs(void)
+{
+	UINT8 codecs = CODECBIT(CODEC_LZF)|CODECBIT(CODEC_LZ4);
+#ifdef HAVE_ZLIB
+	codecs |= CODECBIT(CODEC_DEFLATE);
+#endif
+	return codecs;
+}
+
+const char *M_CodecName(codec_t codec)
+{
+	switch (codec)
+	{
+		case CODEC_LZF:     return "LZF";
+		case CODEC_LZ4:     return "LZ4";
+		case CODEC_DEFLATE: return "Deflate";
+		default:            return "Unknown";
+	}
+}
+
+size_t M_Compress(codec_t codec, const void *src, size_t srclen, void *dest, size_t destlen)
+{
+	switch (codec)
+	{
+		case CODEC_LZF:
+			return lzf_compress(src, srclen, dest, destlen);
+		case CODEC_LZ4:
+			return LZ4_Compress(src, srclen, dest, destlen);
+#ifdef HAVE_ZLIB
+		case CODEC_DEFLATE:
+			{
+				uLongf complen = (uLongf)destlen;
+				if (compress2(dest, &complen, src, (uLong)srclen, Z_BEST_COMPRESSION) != Z_OK)
+					return 0;
+				return complen;
+			}
+#endif
+		default:
+			return 0;
+	}
+}
+
+size_t M_Decompress(codec_t codec, const void *src, size_t srclen, void *dest, size_t destlen)
+{
+	switch (codec)
+	{
+		case CODEC_LZF:
+			return lzf_decompress(src, srclen, dest, destlen);
+		case CODEC_LZ4:
+			return LZ4_Decompress(src, srclen, dest, destlen);
+#ifdef HAVE_ZLIB
+		case CODEC_DEFLATE:
+			{
+				uLongf declen = (uLongf)destlen;
+				if (uncompress(dest, &declen, src, (uLong)srclen) != Z_OK)
+					return 0;
+				return declen;
+			}
+#endif
+		default:
+			return 0;
+	}
+}
+
+#define BENCHRUNS 10
+
+void M_BenchmarkCodecs(const void *data, size_t len)
+{
+	UINT8 *compressed = malloc(len);
+	UINT8 *decompressed = malloc(len);
+	double precision = I_GetPrecisePrecision() / 1000000.0; // microseconds
+	codec_t codec;
+
+	if (!compressed || !decompressed || !len)
+	{
+		free(compressed);
+		free(decompressed);
+		return;
+	}
+
+	CONS_Printf("%s bytes, best of %d runs:\n", sizeu1(len), BENCHRUNS);
+	CONS_Printf("\x82%-8s %10s %7s %12s %12s\n", "Codec", "Size", "Ratio", "Encode (us)", "Decode (us)");
+
+	for (codec = 0; codec < NUMCODECS; codec++)
+	{
+		precise_t encode = UINT64_MAX, decode = UINT64_MAX;
+		size_t complen = 0;
+		boolean ok = true;
+		INT32 i;
+
+		if (!(M_SupportedCodecs() & CODECBIT(codec)))
+			continue;
+
+		for (i = 0; i < BENCHRUNS && ok; i++)
+		{
+			precise_t start = I_GetPreciseTime();
+			complen = M_Compress(codec, data, len, compressed, len);
+			encode = min(encode, I_GetPreciseTime() - start);
+			if (!complen)
+				break;
+
+			start = I_GetPreciseTime();
+			ok = (M_Decompress(codec, compressed, complen, decompressed, len) == len
+				&& !memcmp(data, decompressed, len));
+			decode = min(decode, I_GetPreciseTime() - start);
+		}
+
+		if (!complen)
+			CONS_Printf("%-8s %10s\n", M_CodecName(codec), "no gain");
+		else if (!ok)
+			CONS_Printf("%-8s \x85%s\n", M_CodecName(codec), "round trip failed!");
+		else
+			CONS_Printf("%-8s %10s %6.2f%% %12s %12s\n", M_CodecName(codec), sizeu1(complen),
+				100.0 * complen / len, sizeu2((size_t)(encode / precision)), sizeu3((size_t)(decode / precision)));
+	}
+
+	free(compressed);
+	free(decompressed);
+}
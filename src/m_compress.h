@@ -0,0 +1,42 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2023 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_compress.h
+/// \brief Interchangeable compression codecs for network transfers
+
+#ifndef __M_COMPRESS__
+#define __M_COMPRESS__
+
+#include "doomtype.h"
+
+// Don't reorder, the numbers are sent over the network.
+typedef enum
+{
+	CODEC_LZF,     // everyone has this one
+	CODEC_LZ4,     // LZ4 block format, fastest
+	CODEC_DEFLATE, // zlib, smallest
+	NUMCODECS
+} codec_t;
+
+#define CODECBIT(codec) (1<<(codec))
+
+// Bit mask of the codecs this build can decode.
+UINT8 M_SupportedCodecs(void);
+
+const char *M_CodecName(codec_t codec);
+
+// Returns the compressed length, or 0 if it doesn't fit in destlen bytes.
+size_t M_Compress(codec_t codec, const void *src, size_t srclen, void *dest, size_t destlen);
+
+// Returns the decompressed length, or 0 if the data is corrupt or doesn't fit in destlen bytes.
+size_t M_Decompress(codec_t codec, const void *src, size_t srclen, void *dest, size_t destlen);
+
+// Prints the ratio and speed of every supported codec on the given data.
+void M_BenchmarkCodecs(const void *data, size_t len);
+
+#endif
@@ -0,0 +1,211 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2023 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_delta.c
+/// \brief Binary deltas between two versions of a buffer
+///
+///        The base is split into fixed size blocks, which are looked up by a
+///        rolling hash at every position of the new data, so inserted and
+///        removed bytes don't throw off the rest of the match, like rsync.
+///
+///        A delta is the decoded length followed by a list of operations:
+///        DELTA_COPY <offset> <length> copies bytes from the base,
+///        DELTA_LITERAL <length> <bytes> adds new ones, DELTA_END stops.
+///        All numbers are little endian UINT32s.
+
+#include "doomdef.h"
+#include "m_delta.h"
+
+#define DELTABLOCK 32 // smallest run of bytes worth a copy, must fit an operation with room to spare
+#define DELTAHASHMUL 0x01000193u
+
+enum
+{
+	DELTA_END,
+	DELTA_COPY,
+	DELTA_LITERAL
+};
+
+static void M_DeltaPutUINT32(UINT8 *p, UINT32 v)
+{
+	p[0] = (UINT8)v;
+	p[1] = (UINT8)(v>>8);
+	p[2] = (UINT8)(v>>16);
+	p[3] = (UINT8)(v>>24);
+}
+
+static UINT32 M_DeltaGetUINT32(const UINT8 *p)
+{
+	return p[0] | (p[1]<<8) | (p[2]<<16) | ((UINT32)p[3]<<24);
+}
+
+static UINT32 M_DeltaHashBlock(const UINT8 *p)
+{
+	UINT32 h = 0;
+	size_t i;
+
+	for (i = 0; i < DELTABLOCK; i++)
+		h = h*DELTAHASHMUL + p[i];
+	return h;
+}
+
+typedef struct
+{
+	UINT8 *p, *end;
+} deltawriter_t;
+
+static boolean M_DeltaWriteLiteral(deltawriter_t *w, const UINT8 *data, size_t len)
+{
+	if (!len)
+		return true;
+	if ((size_t)(w->end - w->p) < 5 + len)
+		return false;
+	*w->p++ = DELTA_LITERAL;
+	M_DeltaPutUINT32(w->p, (UINT32)len);
+	M_Memcpy(w->p + 4, data, len);
+	w->p += 4 + len;
+	return true;
+}
+
+static boolean M_DeltaWriteCopy(deltawriter_t *w, size_t offset, size_t len)
+{
+	if (w->end - w->p < 9)
+		return false;
+	*w->p++ = DELTA_COPY;
+	M_DeltaPutUINT32(w->p, (UINT32)offset);
+	M_DeltaPutUINT32(w->p + 4, (UINT32)len);
+	w->p += 8;
+	return true;
+}
+
+size_t M_DeltaEncode(const UINT8 *base, size_t baselen, const UINT8 *data, size_t datalen, UINT8 *dest, size_t destlen)
+{
+	deltawriter_t w;
+	UINT32 *blocks; // base offset + 1 of a block with each hash, 0 if none
+	size_t numblocks = baselen / DELTABLOCK;
+	size_t mask, i;
+	size_t pos, literal; // where we are, where the pending literal bytes start
+	UINT32 h, outmul;
+	boolean ok = true;
+
+	if (destlen < 4 || datalen > UINT32_MAX || baselen > UINT32_MAX)
+		return 0;
+
+	w.p = dest;
+	w.end = dest + destlen;
+	M_DeltaPutUINT32(w.p, (UINT32)datalen);
+	w.p += 4;
+
+	for (mask = 1; mask < numblocks*2; mask <<= 1)
+		;
+	blocks = calloc(mask, sizeof (*blocks));
+	if (!blocks)
+		return 0;
+	mask--;
+
+	// Later blocks overwrite earlier ones, which is as good as anything.
+	for (i = 0; i < numblocks; i++)
+		blocks[M_DeltaHashBlock(base + i*DELTABLOCK) & mask] = (UINT32)(i*DELTABLOCK + 1);
+
+	// Multiplier of the byte leaving the rolling hash window
+	for (outmul = 1, i = 1; i < DELTABLOCK; i++)
+		outmul *= DELTAHASHMUL;
+
+	pos = literal = 0;
+	h = (numblocks && datalen >= DELTABLOCK) ? M_DeltaHashBlock(data) : 0;
+
+	while (ok && numblocks && pos + DELTABLOCK <= datalen)
+	{
+		UINT32 match = blocks[h & mask];
+
+		if (match && !memcmp(base + match - 1, data + pos, DELTABLOCK))
+		{
+			size_t from = match - 1, len = DELTABLOCK;
+
+			// Grow the match both ways, taking back literal bytes before it.
+			while (pos > literal && from > 0 && base[from-1] == data[pos-1])
+				from--, pos--, len++;
+			while (from + len < baselen && pos + len < datalen && base[from+len] == data[pos+len])
+				len++;
+
+			ok = M_DeltaWriteLiteral(&w, data + literal, pos - literal)
+				&& M_DeltaWriteCopy(&w, from, len);
+
+			pos = literal = pos + len;
+			if (pos + DELTABLOCK <= datalen)
+				h = M_DeltaHashBlock(data + pos);
+			continue;
+		}
+
+		if (pos + DELTABLOCK < datalen)
+			h = (h - data[pos]*outmul)*DELTAHASHMUL + data[pos + DELTABLOCK];
+		pos++;
+	}
+
+	free(blocks);
+
+	if (!ok || !M_DeltaWriteLiteral(&w, data + literal, datalen - literal) || w.p == w.end)
+		return 0;
+	*w.p++ = DELTA_END;
+
+	return w.p - dest;
+}
+
+size_t M_DeltaDecodedLength(const UINT8 *delta, size_t deltalen)
+{
+	if (deltalen < 5)
+		return 0;
+	return M_DeltaGetUINT32(delta);
+}
+
+size_t M_DeltaDecode(const UINT8 *base, size_t baselen, const UINT8 *delta, size_t deltalen, UINT8 *dest, size_t destlen)
+{
+	const UINT8 *p = delta + 4, *end = delta + deltalen;
+	size_t length = M_DeltaDecodedLength(delta, deltalen);
+	size_t pos = 0;
+
+	if (!length || length > destlen)
+		return 0;
+
+	while (p < end)
+	{
+		size_t offset, len;
+
+		switch (*p++)
+		{
+			case DELTA_END:
+				return (pos == length) ? length : 0;
+			case DELTA_COPY:
+				if (end - p < 8)
+					return 0;
+				offset = M_DeltaGetUINT32(p);
+				len = M_DeltaGetUINT32(p + 4);
+				p += 8;
+				if (offset > baselen || len > baselen - offset || len > length - pos)
+					return 0;
+				M_Memcpy(dest + pos, base + offset, len);
+				pos += len;
+				break;
+			case DELTA_LITERAL:
+				if (end - p < 4)
+					return 0;
+				len = M_DeltaGetUINT32(p);
+				p += 4;
+				if (len > (size_t)(end - p) || len > length - pos)
+					return 0;
+				M_Memcpy(dest + pos, p, len);
+				p += len;
+				pos += len;
+				break;
+			default:
+				return 0;
+		}
+	}
+
+	return 0; // no DELTA_END
+}
@@ -0,0 +1,28 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2023 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_delta.h
+/// \brief Binary deltas between two versions of a buffer
+
+#ifndef __M_DELTA__
+#define __M_DELTA__
+
+#include "doomtype.h"
+
+// Describes data as ranges copied from base plus the bytes that aren't in it.
+// Returns the length of the delta, or 0 if it doesn't fit in destlen bytes.
+size_t M_DeltaEncode(const UINT8 *base, size_t baselen, const UINT8 *data, size_t datalen, UINT8 *dest, size_t destlen);
+
+// Length of the data a delta decodes to, or 0 if it isn't a delta.
+size_t M_DeltaDecodedLength(const UINT8 *delta, size_t deltalen);
+
+// Rebuilds the data from base and a delta made against it.
+// Returns the decoded length, or 0 if the delta is corrupt or doesn't fit in destlen bytes.
+size_t M_DeltaDecode(const UINT8 *base, size_t baselen, const UINT8 *delta, size_t deltalen, UINT8 *dest, size_t destlen);
+
+#endif
@@ -0,0 +1,236 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2023 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_jobs.c
+/// \brief Worker thread pool for short, independent jobs
+///
+///        The workers are started the first time a job is added. Use
+///        -jobthreads <n> to override how many there are; 0 runs every job
+///        on the main thread.
+
+#include "doomdef.h"
+#include "i_system.h"
+#include "i_threads.h"
+#include "m_argv.h"
+#include "m_jobs.h"
+
+#define MAXJOBTHREADS 16
+
+typedef struct
+{
+	jobfunc_t func;
+	void *userdata;
+	jobgroup_t *group;
+} job_t;
+
+static INT32 numjobthreads = -1; // -1 until the pool is started
+
+#ifdef HAVE_THREADS
+static job_t *jobqueue; // ring buffer
+static size_t jobqueuesize, jobqueuehead, jobqueuecount;
+
+static boolean jobsstopping;
+
+static I_mutex jobs_mutex;
+static I_cond jobs_cond; // a job was queued, or the pool is stopping
+static I_cond jobsdone_cond; // a job finished
+
+// Takes the next job off the queue. The pool must be locked.
+static boolean M_PopJob(job_t *job)
+{
+	if (!jobqueuecount)
+		return false;
+
+	*job = jobqueue[jobqueuehead];
+	jobqueuehead = (jobqueuehead + 1) % jobqueuesize;
+	jobqueuecount--;
+	return true;
+}
+
+// Runs a job with the pool unlocked, then relocks it and marks it as done.
+static void M_RunJob(const job_t *job)
+{
+	I_unlock_mutex(jobs_mutex);
+	job->func(job->userdata);
+	I_lock_mutex(&jobs_mutex);
+
+	job->group->pending--;
+	I_wake_all_cond(&jobsdone_cond);
+}
+
+static void M_JobThread(void *userdata)
+{
+	job_t job;
+
+	(void)userdata;
+
+	I_lock_mutex(&jobs_mutex);
+	while (!jobsstopping && !I_thread_is_stopped())
+	{
+		if (M_PopJob(&job))
+			M_RunJob(&job);
+		else
+			I_hold_cond(&jobs_cond, jobs_mutex);
+	}
+	I_unlock_mutex(jobs_mutex);
+}
+
+// Registered as an exit function, so it runs before I_stop_threads joins the workers.
+static void M_StopJobs(void)
+{
+	I_lock_mutex(&jobs_mutex);
+	jobsstopping = true;
+	I_wake_all_cond(&jobs_cond);
+	I_unlock_mutex(jobs_mutex);
+}
+#endif
+
+static void M_StartJobs(void)
+{
+	INT32 i;
+
+	if (M_CheckParm("-jobthreads") && M_IsNextParm())
+		numjobthreads = atoi(M_GetNextParm());
+	else
+#ifdef HAVE_THREADS
+		numjobthreads = I_cpu_count() - 1; // the main thread helps out too
+#else
+		numjobthreads = 0;
+#endif
+
+	numjobthreads = max(0, min(numjobthreads, MAXJOBTHREADS));
+
+#ifdef HAVE_THREADS
+	if (numjobthreads)
+		I_AddExitFunc(M_StopJobs);
+
+	for (i = 0; i < numjobthreads; i++)
+		I_spawn_thread("job-worker", M_JobThread, NULL);
+#else
+	(void)i;
+#endif
+}
+
+void M_AddJob(jobgroup_t *group, jobfunc_t func, void *userdata)
+{
+	if (numjobthreads == -1)
+		M_StartJobs();
+
+#ifdef HAVE_THREADS
+	if (numjobthreads)
+	{
+		I_lock_mutex(&jobs_mutex);
+		{
+			if (jobqueuecount == jobqueuesize)
+			{
+				// Grow the ring, unwrapping it into the new space
+				const size_t newsize = jobqueuesize ? jobqueuesize * 2 : 64;
+				job_t *newqueue = malloc(newsize * sizeof (*newqueue));
+				size_t i;
+
+				if (!newqueue)
+					I_Error("M_AddJob: out of memory");
+
+				for (i = 0; i < jobqueuecount; i++)
+					newqueue[i] = jobqueue[(jobqueuehead + i) % jobqueuesize];
+
+				free(jobqueue);
+				jobqueue = newqueue;
+				jobqueuesize = newsize;
+				jobqueuehead = 0;
+			}
+
+			jobqueue[(jobqueuehead + jobqueuecount) % jobqueuesize].func = func;
+			jobqueue[(jobqueuehead + jobqueuecount) % jobqueuesize].userdata = userdata;
+			jobqueue[(jobqueuehead + jobqueuecount) % jobqueuesize].group = group;
+			jobqueuecount++;
+			group->pending++;
+
+			I_wake_one_cond(&jobs_cond);
+		}
+		I_unlock_mutex(jobs_mutex);
+		return;
+	}
+#else
+	(void)group;
+#endif
+
+	func(userdata);
+}
+
+void M_WaitJobs(jobgroup_t *group)
+{
+#ifdef HAVE_THREADS
+	job_t job;
+
+	if (numjobthreads <= 0)
+		return;
+
+	I_lock_mutex(&jobs_mutex);
+	while (group->pending)
+	{
+		if (M_PopJob(&job))
+			M_RunJob(&job);
+		else
+			I_hold_cond(&jobsdone_cond, jobs_mutex);
+	}
+	I_unlock_mutex(jobs_mutex);
+#else
+	(void)group;
+#endif
+}
+
+typedef struct
+{
+	jobrangefunc_t func;
+	void *userdata;
+	size_t start, end;
+} jobrange_t;
+
+static void M_RangeJob(void *userdata)
+{
+	const jobrange_t *range = userdata;
+	range->func(range->userdata, range->start, range->end);
+}
+
+void M_RunJobRange(jobrangefunc_t func, void *userdata, size_t count, size_t minrange)
+{
+	jobrange_t ranges[MAXJOBTHREADS + 1];
+	jobgroup_t group = {0};
+	size_t numranges, i;
+
+	numranges = min(count / max(minrange, 1), (size_t)M_NumJobThreads() + 1);
+
+	if (numranges <= 1)
+	{
+		func(userdata, 0, count);
+		return;
+	}
+
+	for (i = 0; i < numranges; i++)
+	{
+		ranges[i].func = func;
+		ranges[i].userdata = userdata;
+		ranges[i].start = count * i / numranges;
+		ranges[i].end = count * (i + 1) / numranges;
+	}
+
+	// Keep the last one for ourselves
+	for (i = 0; i < numranges - 1; i++)
+		M_AddJob(&group, M_RangeJob, &ranges[i]);
+	M_RangeJob(&ranges[numranges - 1]);
+
+	M_WaitJobs(&group);
+}
+
+INT32 M_NumJobThreads(void)
+{
+	if (numjobthreads == -1)
+		M_StartJobs();
+	return numjobthreads;
+}
@@ -0,0 +1,46 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2023 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  m_jobs.h
+/// \brief Worker thread pool for short, independent jobs
+
+#ifndef __M_JOBS__
+#define __M_JOBS__
+
+#include "doomtype.h"
+
+typedef void (*jobfunc_t)(void *userdata);
+
+// Jobs that can be waited on together.
+// Zero it before adding the first job.
+typedef struct
+{
+	INT32 pending; // jobs queued or running, guarded by the pool
+} jobgroup_t;
+
+// Queues a job. Only call this from the main thread.
+// Without thread support, or with no worker threads, it runs right away.
+// Jobs must not use the zone allocator, the console, or anything else that
+// isn't thread-safe.
+void M_AddJob(jobgroup_t *group, jobfunc_t func, void *userdata);
+
+// Waits until every job of the group has finished.
+// The calling thread runs queued jobs itself instead of idling.
+void M_WaitJobs(jobgroup_t *group);
+
+typedef void (*jobrangefunc_t)(void *userdata, size_t start, size_t end);
+
+// Splits [0, count) into ranges of at least minrange items, runs them on the
+// job threads and the calling thread, and waits for all of them.
+// Too few items for two ranges just run on the calling thread.
+void M_RunJobRange(jobrangefunc_t func, void *userdata, size_t count, size_t minrange);
+
+// Number of worker threads, not counting the main thread.
+INT32 M_NumJobThreads(void);
+
+#endif
@@ -51,7 +51,8 @@ ps_metric_t ps_tictime = {0};
 ps_metric_t ps_playerthink_time = {0};
 ps_metric_t ps_thinkertime = {0};
 
-//ps_metric_t ps_thlist_times[NUM_THINKERLISTS];
+ps_metric_t ps_dynslopes_time = {0};
+ps_metric_t ps_thlist_times[NUM_THINKERLISTS];
 
 static ps_metric_t ps_thinkercount = {0};
 static ps_metric_t ps_mobjcount = {0};
@@ -67,8 +68,12 @@ ps_metric_t ps_checkposition_calls = {0};
 ps_metric_t ps_lua_prethinkframe_time = {0};
 ps_metric_t ps_lua_thinkframe_time = {0};
 ps_metric_t ps_lua_postthinkframe_time = {0};
+ps_metric_t ps_lua_gc_time = {0};
+ps_metric_t ps_lua_gc_pause = {0};
 
 ps_metric_t ps_lua_mobjhooks = {0};
+ps_metric_t ps_lua_allocs = {0};
+ps_metric_t ps_lua_memory = {0};
 
 ps_metric_t ps_otherlogictime = {0};
 
@@ -87,6 +92,10 @@ ps_metric_t ps_otherlogictime = {0};
 perfstatrow_t rendertime_rows[] = {
 	{"frmtime", "Frame time:    ", &ps_frametime, PS_TIME},
 	{"drwtime", "3d rendering:  ", &ps_rendercalltime, PS_TIME|PS_LEVEL},
+	{" view 1 ", " View 1:        ", &ps_viewtimes[0], PS_TIME|PS_LEVEL|PS_HIDE_ZERO},
+	{" view 2 ", " View 2:        ", &ps_viewtimes[1], PS_TIME|PS_LEVEL|PS_HIDE_ZERO},
+	{" view 3 ", " View 3:        ", &ps_viewtimes[2], PS_TIME|PS_LEVEL|PS_HIDE_ZERO},
+	{" view 4 ", " View 4:        ", &ps_viewtimes[3], PS_TIME|PS_LEVEL|PS_HIDE_ZERO},
 
 #ifdef HWRENDER
 	{" skybox ", " Skybox render: ", &ps_skyboxtime, PS_TIME|PS_LEVEL|PS_HW},
@@ -123,6 +132,9 @@ perfstatrow_t commoncounter_rows[] = {
 	{"sprites", "Sprites:     ", &ps_numsprites, 0},
 	{"drwnode", "Drawnodes:   ", &ps_numdrawnodes, 0},
 	{"plyobjs", "Polyobjects: ", &ps_numpolyobjects, 0},
+	{"visplns", "Visplanes:   ", &ps_numvisplanes, PS_SW},
+	{"plmerge", "Plane merges:", &ps_numplanemerges, PS_SW},
+	{"slopvec", "Slope vecs:  ", &ps_numslopevectors, PS_SW},
 	{0}
 };
 
@@ -155,14 +167,14 @@ perfstatrow_t gamelogic_rows[] = {
 	{"logic  ", "Game logic:     ", &ps_tictime, PS_TIME},
 	{" plrthnk", " P_PlayerThink:  ", &ps_playerthink_time, PS_TIME|PS_LEVEL},
 	{" thnkers", " P_RunThinkers:  ", &ps_thinkertime, PS_TIME|PS_LEVEL},
-/*	{"  plyobjs", "  Polyobjects:    ", &ps_thlist_times[THINK_POLYOBJ], PS_TIME|PS_LEVEL},
+	{"  dynslop", "  Dynamic slopes: ", &ps_dynslopes_time, PS_TIME|PS_LEVEL},
+	{"  plyobjs", "  Polyobjects:    ", &ps_thlist_times[THINK_POLYOBJ], PS_TIME|PS_LEVEL},
 	{"  main   ", "  Main:           ", &ps_thlist_times[THINK_MAIN], PS_TIME|PS_LEVEL},
 	{"  mobjs  ", "  Mobjs:          ", &ps_thlist_times[THINK_MOBJ], PS_TIME|PS_LEVEL},
-	{"  dynslop", "  Dynamic slopes: ", &ps_thlist_times[THINK_DYNSLOPE], PS_TIME|PS_LEVEL},
-	{"  precip ", "  Precipitation:  ", &ps_thlist_times[THINK_PRECIP], PS_TIME|PS_LEVEL},*/
 	{" lprethinkf", " LUAh_PreThinkFrame:", &ps_lua_prethinkframe_time, PS_TIME|PS_LEVEL},
 	{" lthinkf", " LUAh_ThinkFrame:", &ps_lua_thinkframe_time, PS_TIME|PS_LEVEL},
 	{" lpostthinkf", " LUAh_PostThinkFrame:", &ps_lua_postthinkframe_time, PS_TIME|PS_LEVEL},
+	{" luagc  ", " Lua GC step:    ", &ps_lua_gc_time, PS_TIME|PS_LEVEL|PS_HIDE_ZERO},
 	{" other  ", " Other:          ", &ps_otherlogictime, PS_TIME|PS_LEVEL},
 	{0}
 };
@@ -181,6 +193,9 @@ perfstatrow_t thinkercount_rows[] = {
 
 perfstatrow_t misc_calls_rows[] = {
 	{"lmhook", "Lua mobj hooks: ", &ps_lua_mobjhooks, PS_LEVEL},
+	{"lalloc", "Lua allocs:     ", &ps_lua_allocs, PS_LEVEL},
+	{"lmemory", "Lua memory KB:  ", &ps_lua_memory, 0},
+	{"lgcnext", "Lua GC next KB: ", &ps_lua_gc_pause, PS_HIDE_ZERO},
 	{"chkpos", "P_CheckPosition:", &ps_checkposition_calls, PS_LEVEL},
 	{0}
 };
@@ -566,6 +581,7 @@ static void PS_UpdateFrameStats(void)
 static void PS_CountThinkers(void)
 {
 	thinker_t *thinker;
+	UINT8 i;
 
 	ps_thinkercount.value.i = 0;
 	ps_mobjcount.value.i = 0;
@@ -575,60 +591,32 @@ static void PS_CountThinkers(void)
 	ps_precipcount.value.i = 0;
 	ps_otherthcount.value.i = 0;
 	ps_removecount.value.i = 0;
-	for (thinker = thinkercap.next; thinker != &thinkercap; thinker = thinker->next)
-	{
-		if (thinker->function.acp1 != (actionf_p1)P_NullPrecipThinker)
-			ps_thinkercount.value.i++;
-
-		if (thinker->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			ps_removecount.value.i++;
-		else if (thinker->function.acp1 == (actionf_p1)P_MobjThinker)
-		{
-			mobj_t *mobj = (mobj_t*)thinker;
-			ps_mobjcount.value.i++;
-			if (mobj->flags & MF_NOTHINK)
-				ps_nothinkcount.value.i++;
-			else if (mobj->flags & MF_SCENERY)
-				ps_scenerycount.value.i++;
-			else
-				ps_regularcount.value.i++;
-		}
-		else if (thinker->function.acp1 == (actionf_p1)P_NullPrecipThinker)
-			ps_precipcount.value.i++;
-		else
-			ps_otherthcount.value.i++;
-	}
-	/*for (i = 0; i < NUM_THINKERLISTS; i++)
+	for (i = 0; i < NUM_THINKERLISTS; i++)
 	{
 		for (thinker = thlist[i].next; thinker != &thlist[i]; thinker = thinker->next)
 		{
-			ps_thinkercount.value.i++;
+			if (i != THINK_PRECIP)
+				ps_thinkercount.value.i++;
+
 			if (thinker->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
 				ps_removecount.value.i++;
-			else if (i == THINK_POLYOBJ)
-				ps_polythcount.value.i++;
-			else if (i == THINK_MAIN)
-				ps_mainthcount.value.i++;
 			else if (i == THINK_MOBJ)
 			{
-				if (thinker->function.acp1 == (actionf_p1)P_MobjThinker)
-				{
-					mobj_t *mobj = (mobj_t*)thinker;
-					ps_mobjcount.value.i++;
-					if (mobj->flags & MF_NOTHINK)
-						ps_nothinkcount.value.i++;
-					else if (mobj->flags & MF_SCENERY)
-						ps_scenerycount.value.i++;
-					else
-						ps_regularcount.value.i++;
-				}
+				mobj_t *mobj = (mobj_t*)thinker;
+				ps_mobjcount.value.i++;
+				if (mobj->flags & MF_NOTHINK)
+					ps_nothinkcount.value.i++;
+				else if (mobj->flags & MF_SCENERY)
+					ps_scenerycount.value.i++;
+				else
+					ps_regularcount.value.i++;
 			}
-			else if (i == THINK_DYNSLOPE)
-				ps_dynslopethcount.value.i++;
 			else if (i == THINK_PRECIP)
 				ps_precipcount.value.i++;
+			else
+				ps_otherthcount.value.i++;
 		}
-	}*/
+	}
 }
 
 // Update all metrics that are calculated on every tick.
@@ -648,13 +636,16 @@ void PS_UpdateTickStats(void)
 				ps_thinkertime.value.p -
 				ps_lua_prethinkframe_time.value.p -
 				ps_lua_thinkframe_time.value.p -
-				ps_lua_postthinkframe_time.value.p;
+				ps_lua_postthinkframe_time.value.p -
+				ps_lua_gc_time.value.p;
 
 
 
 			PS_CountThinkers();
 		}
 
+		ps_lua_memory.value.i = (INT32)(LUA_MemoryUsage()>>10);
+
 		if (cv_ps_samplesize.value > 1)
 		{
 			PS_UpdateRowHistories(gamelogic_rows, false);
@@ -40,6 +40,7 @@ extern ps_metric_t ps_tictime;
 extern ps_metric_t ps_playerthink_time;
 extern ps_metric_t ps_thinkertime;
 
+extern ps_metric_t ps_dynslopes_time;
 extern ps_metric_t ps_thlist_times[];
 
 extern ps_metric_t ps_checkposition_calls;
@@ -47,7 +48,11 @@ extern ps_metric_t ps_checkposition_calls;
 extern ps_metric_t ps_lua_prethinkframe_time;
 extern ps_metric_t ps_lua_thinkframe_time;
 extern ps_metric_t ps_lua_postthinkframe_time;
+extern ps_metric_t ps_lua_gc_time;
+extern ps_metric_t ps_lua_gc_pause;
 extern ps_metric_t ps_lua_mobjhooks;
+extern ps_metric_t ps_lua_allocs;
+extern ps_metric_t ps_lua_memory;
 
 extern ps_metric_t ps_otherlogictime;
 
@@ -66,11 +66,25 @@ extern consvar_t cv_newwatersplash;
 // P_TICK
 //
 
-// both the head and tail of the thinker list
-extern thinker_t thinkercap;
+typedef enum
+{
+	THINK_POLYOBJ,
+	THINK_MAIN,
+	THINK_MOBJ,
+	THINK_PRECIP, // never runs, see P_NullPrecipThinker
+	NUM_THINKERLISTS
+} thinklistnum_t;
+
+// both the head and tail of each thinker list
+extern thinker_t thlist[NUM_THINKERLISTS];
+
+// both the head and tail of the run order, through runnext
+extern thinker_t thinkrun;
 
 void P_InitThinkers(void);
-void P_AddThinker(thinker_t *thinker);
+void P_AddThinker(const thinklistnum_t n, thinker_t *thinker);
+void P_AddThinkerFirst(const thinklistnum_t n, thinker_t *thinker);
+thinker_t *P_NextThinker(const thinker_t *th, thinklistnum_t last);
 void P_RemoveThinker(thinker_t *thinker);
 void P_UnlinkThinker(thinker_t *thinker);
 
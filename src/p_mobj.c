@@ -33,6 +33,7 @@
 #include "lua_hook.h"
 #include "b_bot.h"
 #include "p_slopes.h"
+#include "p_tags.h"
 
 #include "k_kart.h"
 
@@ -3225,7 +3226,7 @@ void P_DestroyRobots(void)
 	mobj_t *mo;
 	thinker_t *think;
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
 	{
 		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -4057,7 +4058,7 @@ static void P_Boss3Thinker(mobj_t *mobj)
 
 			// scan the thinkers to make sure all the old pinch dummies are gone before making new ones
 			// this can happen if the boss was hurt earlier than expected
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 			{
 				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 					continue;
@@ -4148,7 +4149,7 @@ static void P_Boss3Thinker(mobj_t *mobj)
 		// scan the thinkers
 		// to find a point that matches
 		// the number
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -4248,16 +4249,14 @@ static boolean P_Boss4MoveCage(fixed_t delta)
 	const UINT16 tag = 65534;
 	INT32 snum;
 	sector_t *sector;
-	for (snum = sectors[tag%numsectors].firsttag; snum != -1; snum = sector->nexttag)
+	for (snum = -1; (snum = Tag_Next(tags_sectors, (INT16)tag, snum)) != -1;)
 	{
 		sector = &sectors[snum];
-		if (sector->tag != tag)
-			continue;
 		sector->floorheight += delta;
 		sector->ceilingheight += delta;
 		P_CheckSector(sector, true);
 	}
-	return sectors[tag%numsectors].firsttag != -1;
+	return Tag_Count(tags_sectors, (INT16)tag) != 0;
 }
 
 // Move Boss4's arms to angle
@@ -4295,25 +4294,17 @@ static void P_Boss4PinchSpikeballs(mobj_t *mobj, angle_t angle, fixed_t fz)
 static void P_Boss4DestroyCage(void)
 {
 	const UINT16 tag = 65534;
-	INT32 snum, next;
+	INT32 snum;
 	size_t a;
 	sector_t *sector, *rsec;
 	ffloor_t *rover;
 
 	// This will be the final iteration of sector tag.
-	// We'll destroy the tag list as we go.
-	next = sectors[tag%numsectors].firsttag;
-	sectors[tag%numsectors].firsttag = -1;
-
-	for (snum = next; snum != -1; snum = next)
+	// We'll empty the tag list as we go.
+	for (snum = -1; (snum = Tag_Next(tags_sectors, (INT16)tag, snum)) != -1;)
 	{
 		sector = &sectors[snum];
-
-		next = sector->nexttag;
-		sector->nexttag = -1;
-		if (sector->tag != tag)
-			continue;
-		sector->tag = 0;
+		P_ChangeSectorTag(snum, 0);
 
 		// Destroy the FOFs.
 		for (a = 0; a < sector->numattached; a++)
@@ -4783,7 +4774,7 @@ static void P_Boss7Thinker(mobj_t *mobj)
 				closestdist = 16384*FRACUNIT; // Just in case...
 
 				// Find waypoint he is closest to
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 				{
 					if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 						continue;
@@ -4838,7 +4829,7 @@ static void P_Boss7Thinker(mobj_t *mobj)
 
 		// scan the thinkers to find
 		// the waypoint to use
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -4961,7 +4952,7 @@ static void P_Boss9Thinker(mobj_t *mobj)
 
 		// Run through the thinkers ONCE and find all of the MT_BOSS9GATHERPOINT in the map.
 		// Build a hoop linked list of 'em!
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -5421,7 +5412,7 @@ mobj_t *P_GetClosestAxis(mobj_t *source)
 	fixed_t dist1, dist2 = 0;
 
 	// scan the thinkers to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -9780,7 +9771,7 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	}
 
 	if (!(mobj->flags & MF_NOTHINK))
-		P_AddThinker(&mobj->thinker); // Needs to come before the shadow spawn, or else the shadow's reference gets forgotten
+		P_AddThinker(THINK_MOBJ, &mobj->thinker); // Needs to come before the shadow spawn, or else the shadow's reference gets forgotten
 
 	switch (mobj->type)
 	{
@@ -9917,7 +9908,7 @@ mobj_t *P_SpawnShadowMobj(mobj_t * caster)
 		mobj->eflags |= MFE_ONGROUND;
 
 	if (!(mobj->flags & MF_NOTHINK))
-		P_AddThinker(&mobj->thinker);
+		P_AddThinker(THINK_MOBJ, &mobj->thinker);
 
 	// Call action functions when the state is set
 	if (st->action.acp1 && (mobj->flags & MF_RUNSPAWNFUNC))
@@ -9988,7 +9979,7 @@ static precipmobj_t *P_SpawnPrecipMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype
 	mobj->momz = cv_mobjscaleprecip.value ? FixedMul(info->speed, mapobjectscale) : info->speed;
 
 	mobj->thinker.function.acp1 = (actionf_p1)P_NullPrecipThinker;
-	P_AddThinker(&mobj->thinker);
+	P_AddThinker(THINK_PRECIP, &mobj->thinker);
 
 	CalculatePrecipFloor(mobj);
 
@@ -10122,7 +10113,7 @@ void P_RemoveMobj(mobj_t *mobj)
 		else
 		{ // Add thinker just to delay removing it until refrences are gone.
 			mobj->flags &= ~MF_NOTHINK;
-			P_AddThinker((thinker_t *)mobj);
+			P_AddThinker(THINK_MOBJ, (thinker_t *)mobj);
 #ifdef SCRAMBLE_REMOVED
 			// Invalidate mobj_t data to cause crashes if accessed!
 			memset((UINT8 *)mobj + sizeof(thinker_t), 0xff, sizeof(mobj_t) - sizeof(thinker_t));
@@ -10200,85 +10191,166 @@ static CV_PossibleValue_t flagtime_cons_t[] = {{0, "MIN"}, {300, "MAX"}, {0, NUL
 consvar_t cv_flagtime = {"flagtime", "30", CV_NETVAR|CV_CHEAT|CV_NOSHOWHELP, flagtime_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 consvar_t cv_suddendeath = {"suddendeath", "Off", CV_NETVAR|CV_CHEAT|CV_NOSHOWHELP, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 
-void P_SpawnPrecipitation(void)
+// Precipitation only exists around the local views. Blockmap cells fill in
+// when a renderer first looks at them and empty again once none has for a
+// while, so the cost follows the view area instead of the map's size.
+#define PRECIPLINGER TICRATE
+
+static tic_t *precipseen; // leveltime+1 a cell was last drawn, 0 if it is empty
+static INT32 *preciplive; // the cells that are filled
+static size_t numpreciplive;
+static tic_t precipsweeptime;
+
+static void P_FreePrecipitationBlock(INT32 i)
 {
-	INT32 i, mrand;
+	precipmobj_t *th, *next;
+
+	for (th = precipblocklinks[i]; th; th = next)
+	{
+		next = th->bnext;
+		P_FreePrecipMobj(th);
+	}
+
+	precipseen[i] = 0;
+}
+
+static void P_SpawnPrecipitationBlock(INT32 i)
+{
+	INT32 mrand;
 	fixed_t basex, basey, j, x, y, z;
 	subsector_t *precipsector = NULL;
 	precipmobj_t *rainmo = NULL;
 
-	if (dedicated || !cv_drawdist_precip.value || curWeather == PRECIP_NONE) // SRB2Kart
+	basex = bmaporgx + (i % bmapwidth) * MAPBLOCKSIZE;
+	basey = bmaporgy + (i / bmapwidth) * MAPBLOCKSIZE;
+
+	// Leave out a bit more than half of the cells
+	if (cv_lessprecip.value && M_RandomKey(9) >= 4)
 		return;
 
-	// Use the blockmap to narrow down our placing patterns
-	for (i = 0; i < bmapwidth*bmapheight; ++i)
+	for (j = 0; j < FRACUNIT; j += cv_mobjscaleprecip.value ? mapobjectscale : FRACUNIT)
 	{
-		basex = bmaporgx + (i % bmapwidth) * MAPBLOCKSIZE;
-		basey = bmaporgy + (i / bmapwidth) * MAPBLOCKSIZE;
+		INT32 floorz;
+		INT32 ceilingz;
+
+		x = basex + ((M_RandomKey(MAPBLOCKUNITS<<3)<<FRACBITS)>>3);
+		y = basey + ((M_RandomKey(MAPBLOCKUNITS<<3)<<FRACBITS)>>3);
 
-		for (j = 0; j < FRACUNIT; j += cv_mobjscaleprecip.value ? mapobjectscale : FRACUNIT)
+		precipsector = R_IsPointInSubsector(x, y);
+
+		// No sector? Stop wasting time,
+		// move on to the next entry in the blockmap
+		if (!precipsector)
+			continue;
+
+		// Not in a sector with visible sky?
+		if (precipsector->sector->ceilingpic != skyflatnum)
+			continue;
+
+		// Exists, but is too small for reasonable precipitation.
+		if (!(precipsector->sector->floorheight <= precipsector->sector->ceilingheight - (32<<FRACBITS)))
+			continue;
+
+		// Don't set z properly yet...
+		z = precipsector->sector->ceilingheight;
+
+		if (curWeather == PRECIP_SNOW)
 		{
-			INT32 floorz;
-			INT32 ceilingz;
+			rainmo = P_SpawnPrecipMobj(x, y, z, MT_SNOWFLAKE);
+			mrand = M_RandomByte();
+			if (mrand < 64)
+				P_SetPrecipMobjState(rainmo, S_SNOW3);
+			else if (mrand < 144)
+				P_SetPrecipMobjState(rainmo, S_SNOW2);
+		}
+		else // everything else.
+			rainmo = P_SpawnPrecipMobj(x, y, z, MT_RAIN);
 
-			x = ((cv_lessprecip.value ? basex*1.5 : basex) + ((M_RandomKey(MAPBLOCKUNITS<<3)<<FRACBITS)>>3));
-			y = ((cv_lessprecip.value ? basey*1.5 : basey) + ((M_RandomKey(MAPBLOCKUNITS<<3)<<FRACBITS)>>3));
+		floorz = rainmo->floorz >> FRACBITS;
+		ceilingz = rainmo->ceilingz >> FRACBITS;
 
-			precipsector = R_IsPointInSubsector(x, y);
+		if (floorz < ceilingz)
+		{
+			// Randomly assign a height, now that floorz is set.
+			rainmo->z = M_RandomRange(floorz, ceilingz) << FRACBITS;
+		}
+		else
+		{
+			// ...except if the floor is above the ceiling.
+			rainmo->z = ceilingz << FRACBITS;
+		}
+	}
+}
 
-			// No sector? Stop wasting time,
-			// move on to the next entry in the blockmap
-			if (!precipsector)
-				continue;
+//
+// P_SpawnPrecipitation
+//
+// Empties every cell so the current weather fills them back in as they are drawn.
+//
+void P_SpawnPrecipitation(void)
+{
+	size_t count = bmapwidth*bmapheight;
 
-			// Not in a sector with visible sky?
-			if (precipsector->sector->ceilingpic != skyflatnum)
-				continue;
+	if (dedicated) // SRB2Kart
+		return;
 
-			// Exists, but is too small for reasonable precipitation.
-			if (!(precipsector->sector->floorheight <= precipsector->sector->ceilingheight - (32<<FRACBITS)))
-				continue;
+	if (!precipseen)
+	{
+		precipseen = Z_Calloc(count * sizeof (*precipseen), PU_LEVEL, &precipseen);
+		preciplive = Z_Malloc(count * sizeof (*preciplive), PU_LEVEL, &preciplive);
+		numpreciplive = 0;
+	}
 
-			// Don't set z properly yet...
-			z = precipsector->sector->ceilingheight;
+	while (numpreciplive)
+		P_FreePrecipitationBlock(preciplive[--numpreciplive]);
 
-			if (curWeather == PRECIP_SNOW)
-			{
-				rainmo = P_SpawnPrecipMobj(x, y, z, MT_SNOWFLAKE);
-				mrand = M_RandomByte();
-				if (mrand < 64)
-					P_SetPrecipMobjState(rainmo, S_SNOW3);
-				else if (mrand < 144)
-					P_SetPrecipMobjState(rainmo, S_SNOW2);
-			}
-			else // everything else.
-				rainmo = P_SpawnPrecipMobj(x, y, z, MT_RAIN);
+	precipsweeptime = leveltime;
+}
 
-			floorz = rainmo->floorz >> FRACBITS;
-			ceilingz = rainmo->ceilingz >> FRACBITS;
+//
+// P_UpdatePrecipitationBlocks
+//
+// Fills the blockmap cells in a view's box that are empty, and once a tic,
+// empties the ones no view has drawn in a while.
+//
+void P_UpdatePrecipitationBlocks(INT32 xl, INT32 xh, INT32 yl, INT32 yh)
+{
+	INT32 bx, by;
+	size_t i;
+
+	if (!precipseen || curWeather == PRECIP_NONE)
+		return;
+
+	if (precipsweeptime != leveltime)
+	{
+		precipsweeptime = leveltime;
 
-			if (floorz < ceilingz)
+		for (i = 0; i < numpreciplive;)
+		{
+			if (leveltime + 1 - precipseen[preciplive[i]] > PRECIPLINGER)
 			{
-				// Randomly assign a height, now that floorz is set.
-				rainmo->z = M_RandomRange(floorz, ceilingz) << FRACBITS;
+				P_FreePrecipitationBlock(preciplive[i]);
+				preciplive[i] = preciplive[--numpreciplive];
 			}
 			else
-			{
-				// ...except if the floor is above the ceiling.
-				rainmo->z = ceilingz << FRACBITS;
-			}
+				i++;
 		}
 	}
 
-	if (curWeather == PRECIP_BLANK)
+	for (by = yl; by <= yh; by++)
 	{
-		curWeather = PRECIP_RAIN;
-		P_SwitchWeather(PRECIP_BLANK);
-	}
-	else if (curWeather == PRECIP_STORM_NORAIN)
-	{
-		curWeather = PRECIP_RAIN;
-		P_SwitchWeather(PRECIP_STORM_NORAIN);
+		for (bx = xl; bx <= xh; bx++)
+		{
+			INT32 cell = (by * bmapwidth) + bx;
+
+			if (!precipseen[cell])
+			{
+				P_SpawnPrecipitationBlock(cell);
+				preciplive[numpreciplive++] = cell;
+			}
+
+			precipseen[cell] = leveltime + 1;
+		}
 	}
 }
 
@@ -10417,7 +10489,7 @@ void P_RespawnSpecials(void)
 	{
 		thinker_t *th;
 
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			mobj_t *box;
 			mobj_t *newmobj;
@@ -10626,6 +10698,7 @@ void P_SpawnPlayer(INT32 playernum)
 
 	mobj->player = p;
 	P_SetTarget(&p->mo, mobj);
+	K_UpdatePlayerSnapshot();
 
 	mobj->angle = 0;
 
@@ -11575,7 +11648,7 @@ ML_NOCLIMB : Direction not controllable
 		mobj->health = (mthing->angle / 360) + 1;
 
 		// See if other starposts exist in this level that have the same value.
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
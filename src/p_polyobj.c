@@ -149,10 +149,7 @@ FUNCINLINE static ATTRINLINE void Polyobj_vecSub2(vertex_t *dst, vertex_t *v1, v
 // Unlike P_AddThinker, this adds it to the front of the list instead of the back, so that carrying physics can work right. -Red
 FUNCINLINE static ATTRINLINE void PolyObj_AddThinker(thinker_t *th)
 {
-	thinkercap.next->prev = th;
-	th->next = thinkercap.next;
-	th->prev = &thinkercap;
-	thinkercap.next = th;
+	P_AddThinkerFirst(THINK_POLYOBJ, th);
 }
 
 static void FreeSideLists(void)
@@ -1550,7 +1547,7 @@ void Polyobj_InitLevel(void)
 
 	// run down the thinker list, count the number of spawn points, and save
 	// the mobj_t pointers on a queue for use below.
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
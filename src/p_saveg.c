@@ -32,6 +32,7 @@
 #include "p_polyobj.h"
 #include "lua_script.h"
 #include "p_slopes.h"
+#include "k_kart.h" // K_UpdatePlayerSnapshot
 
 savedata_t savedata;
 
@@ -522,7 +523,6 @@ static void P_NetUnArchiveWaypoints(savebuffer_t *save)
 #define SD_TAG       0x10
 #define SD_FLOORANG  0x20
 #define SD_CEILANG   0x40
-#define SD_TAGLIST   0x80
 
 #define LD_FLAG     0x01
 #define LD_SPECIAL  0x02
@@ -595,8 +595,6 @@ static void P_NetArchiveWorld(savebuffer_t *save)
 
 		if (ss->tag != SHORT(ms->tag))
 			diff2 |= SD_TAG;
-		if (ss->nexttag != ss->spawn_nexttag || ss->firsttag != ss->spawn_firsttag)
-			diff2 |= SD_TAGLIST;
 
 		// Check if any of the sector's FOFs differ from how they spawned
 		if (ss->ffloors)
@@ -648,11 +646,6 @@ static void P_NetArchiveWorld(savebuffer_t *save)
 				WRITEANGLE(put, ss->floorpic_angle);
 			if (diff2 & SD_CEILANG)
 				WRITEANGLE(put, ss->ceilingpic_angle);
-			if (diff2 & SD_TAGLIST) // save both firsttag and nexttag
-			{ // either of these could be changed even if tag isn't
-				WRITEINT32(put, ss->firsttag);
-				WRITEINT32(put, ss->nexttag);
-			}
 
 			// Special case: save the stats of all modified ffloors along with their ffloor "number"s
 			// we don't bother with ffloors that haven't changed, that would just add to savegame even more than is really needed
@@ -833,12 +826,7 @@ static void P_NetUnArchiveWorld(savebuffer_t *save)
 		if (diff2 & SD_CYOFFS)
 			sectors[i].ceiling_yoffs = READFIXED(get);
 		if (diff2 & SD_TAG)
-			sectors[i].tag = READINT16(get); // DON'T use P_ChangeSectorTag
-		if (diff2 & SD_TAGLIST)
-		{
-			sectors[i].firsttag = READINT32(get);
-			sectors[i].nexttag = READINT32(get);
-		}
+			P_ChangeSectorTag(i, READINT16(get)); // the tag lists aren't saved, move it over
 		if (diff2 & SD_FLOORANG)
 			sectors[i].floorpic_angle  = READANGLE(get);
 		if (diff2 & SD_CEILANG)
@@ -1706,7 +1694,9 @@ static void P_NetArchiveThinkers(savebuffer_t *save)
 	WRITEUINT32(save->p, ARCHIVEBLOCK_THINKERS);
 
 	// save off the current thinkers
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	// in the order they run, which loading keeps
+	// precipitation isn't saved, every client spawns its own
+	for (th = thinkrun.runnext; th != &thinkrun; th = th->runnext)
 	{
 		if (!(th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed
 		 || th->function.acp1 == (actionf_p1)P_NullPrecipThinker))
@@ -1915,7 +1905,7 @@ mobj_t *P_FindNewPosition(UINT32 oldposition)
 	thinker_t *th;
 	mobj_t *mobj;
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 	{
 		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue;
@@ -2230,7 +2220,7 @@ static void LoadMobjThinker(savebuffer_t *save, actionf_p1 thinker)
 			skyboxmo[0] = mobj;
 	}
 
-	P_AddThinker(&mobj->thinker);
+	P_AddThinker(THINK_MOBJ, &mobj->thinker);
 
 	if (diff2 & MD2_WAYPOINTCAP)
 		P_SetTarget(&waypointcap, mobj);
@@ -2272,7 +2262,7 @@ static void LoadSpecialLevelThinker(savebuffer_t *save, actionf_p1 thinker, UINT
 			ht->sector->floordata = ht;
 	}
 
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2301,7 +2291,7 @@ static void LoadCeilingThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->sourceline = READFIXED(save->p);
 	if (ht->sector)
 		ht->sector->ceilingdata = ht;
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2325,7 +2315,7 @@ static void LoadFloormoveThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->delaytimer = READFIXED(save->p);
 	if (ht->sector)
 		ht->sector->floordata = ht;
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2342,7 +2332,7 @@ static void LoadLightflashThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->minlight = READINT32(save->p);
 	if (ht->sector)
 		ht->sector->lightingdata = ht;
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2362,7 +2352,7 @@ static void LoadStrobeThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->brighttime = READINT32(save->p);
 	if (ht->sector)
 		ht->sector->lightingdata = ht;
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2381,7 +2371,7 @@ static void LoadGlowThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->speed = READINT32(save->p);
 	if (ht->sector)
 		ht->sector->lightingdata = ht;
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2400,7 +2390,7 @@ static void LoadFireflickerThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->minlight = READINT32(save->p);
 	if (ht->sector)
 		ht->sector->lightingdata = ht;
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2438,7 +2428,7 @@ static void LoadElevatorThinker(savebuffer_t *save, actionf_p1 thinker, UINT8 fl
 			ht->sector->floordata = ht;
 	}
 
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2460,7 +2450,7 @@ static void LoadScrollThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->accel = READINT32(save->p);
 	ht->exclusive = READINT32(save->p);
 	ht->type = READUINT8(save->p);
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2477,7 +2467,7 @@ static inline void LoadFrictionThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->affectee = READINT32(save->p);
 	ht->referrer = READINT32(save->p);
 	ht->roverfriction = READUINT8(save->p);
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2503,7 +2493,7 @@ static void LoadPusherThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->exclusive = READINT32(save->p);
 	ht->slider = READINT32(save->p);
 	ht->source = P_GetPushThing(ht->affectee);
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2523,7 +2513,7 @@ static inline void LoadLaserThinker(savebuffer_t *save, actionf_p1 thinker)
 		if (rover->secnum == (size_t)(ht->sec - sectors)
 		&& rover->master == ht->sourceline)
 			ht->ffloor = rover;
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2540,7 +2530,7 @@ FUNCINLINE static ATTRINLINE void LoadLightlevelThinker(savebuffer_t *save, acti
 	ht->speed = READINT32(save->p);
 	if (ht->sector)
 		ht->sector->lightingdata = ht;
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2556,7 +2546,7 @@ static inline void LoadExecutorThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->caller = LoadMobj(READUINT32(save->p));
 	ht->sector = LoadSector(READUINT32(save->p));
 	ht->timer = READINT32(save->p);
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2575,7 +2565,7 @@ static inline void LoadDisappearThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->affectee = READINT32(save->p);
 	ht->sourceline = READINT32(save->p);
 	ht->exists = READINT32(save->p);
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_MAIN, &ht->thinker);
 }
 
 //
@@ -2591,7 +2581,7 @@ static inline void LoadPolyrotatetThinker(savebuffer_t *save, actionf_p1 thinker
 	ht->speed = READINT32(save->p);
 	ht->distance = READINT32(save->p);
 	ht->turnobjs = READUINT8(save->p);
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_POLYOBJ, &ht->thinker);
 }
 
 //
@@ -2609,7 +2599,7 @@ static void LoadPolymoveThinker(savebuffer_t *save, actionf_p1 thinker)
 	ht->momy = READFIXED(save->p);
 	ht->distance = READINT32(save->p);
 	ht->angle = READANGLE(save->p);
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_POLYOBJ, &ht->thinker);
 }
 
 //
@@ -2634,7 +2624,7 @@ static inline void LoadPolywaypointThinker(savebuffer_t *save, actionf_p1 thinke
 	ht->diffy = READFIXED(save->p);
 	ht->diffz = READFIXED(save->p);
 	ht->target = LoadMobj(READUINT32(save->p));
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_POLYOBJ, &ht->thinker);
 }
 
 //
@@ -2659,7 +2649,7 @@ static inline void LoadPolyslidedoorThinker(savebuffer_t *save, actionf_p1 think
 	ht->momx = READFIXED(save->p);
 	ht->momy = READFIXED(save->p);
 	ht->closing = READUINT8(save->p);
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_POLYOBJ, &ht->thinker);
 }
 
 //
@@ -2679,7 +2669,7 @@ static inline void LoadPolyswingdoorThinker(savebuffer_t *save, actionf_p1 think
 	ht->initDistance = READINT32(save->p);
 	ht->distance = READINT32(save->p);
 	ht->closing = READUINT8(save->p);
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_POLYOBJ, &ht->thinker);
 }
 
 //
@@ -2696,7 +2686,7 @@ static inline void LoadPolydisplaceThinker(savebuffer_t *save, actionf_p1 thinke
 	ht->dx = READFIXED(save->p);
 	ht->dy = READFIXED(save->p);
 	ht->oldHeights = READFIXED(save->p);
-	P_AddThinker(&ht->thinker);
+	P_AddThinker(THINK_POLYOBJ, &ht->thinker);
 }
 
 //
@@ -2715,18 +2705,20 @@ static void P_NetUnArchiveThinkers(savebuffer_t *save)
 		I_Error("Bad $$$.sav at archive block Thinkers");
 
 	// remove all the current thinkers
-	currentthinker = thinkercap.next;
-	for (currentthinker = thinkercap.next; currentthinker != &thinkercap; currentthinker = next)
+	for (i = 0; i < NUM_THINKERLISTS; i++)
 	{
-		next = currentthinker->next;
-
-		if (currentthinker->function.acp1 == (actionf_p1)P_MobjThinker || currentthinker->function.acp1 == (actionf_p1)P_NullPrecipThinker)
-			P_RemoveSavegameMobj((mobj_t *)currentthinker); // item isn't saved, don't remove it
-		else
+		for (currentthinker = thlist[i].next; currentthinker != &thlist[i]; currentthinker = next)
 		{
-			(next->prev = currentthinker->prev)->next = next;
-			R_DestroyLevelInterpolators(currentthinker);
-			Z_Free(currentthinker);
+			next = currentthinker->next;
+
+			if (currentthinker->function.acp1 == (actionf_p1)P_MobjThinker || currentthinker->function.acp1 == (actionf_p1)P_NullPrecipThinker)
+				P_RemoveSavegameMobj((mobj_t *)currentthinker); // item isn't saved, don't remove it
+			else
+			{
+				(next->prev = currentthinker->prev)->next = next;
+				R_DestroyLevelInterpolators(currentthinker);
+				Z_Free(currentthinker);
+			}
 		}
 	}
 
@@ -2910,7 +2902,7 @@ static void P_NetUnArchiveThinkers(savebuffer_t *save)
 		executor_t *delay = NULL;
 		polywaypoint_t *polywp = NULL;
 		UINT32 mobjnum;
-		for (currentthinker = thinkercap.next; currentthinker != &thinkercap;
+		for (currentthinker = thlist[THINK_MAIN].next; currentthinker != &thlist[THINK_MAIN];
 			currentthinker = currentthinker->next)
 		{
 			if (currentthinker->function.acp1 != (actionf_p1)T_ExecutorDelay)
@@ -2921,7 +2913,7 @@ static void P_NetUnArchiveThinkers(savebuffer_t *save)
 			if ((mobjnum = (UINT32)(size_t)delay->caller))
 				delay->caller = P_FindNewPosition(mobjnum);
 		}
-		for (currentthinker = thinkercap.next; currentthinker != &thinkercap;
+		for (currentthinker = thlist[THINK_POLYOBJ].next; currentthinker != &thlist[THINK_POLYOBJ];
 			 currentthinker = currentthinker->next)
 		{
 			if (currentthinker->function.acp1 != (actionf_p1)T_PolyObjWaypoint)
@@ -3035,7 +3027,7 @@ static inline void P_FinishMobjs(void)
 	mobj_t *mobj;
 
 	// put info field there real value
-	for (currentthinker = thinkercap.next; currentthinker != &thinkercap;
+	for (currentthinker = thlist[THINK_MOBJ].next; currentthinker != &thlist[THINK_MOBJ];
 		currentthinker = currentthinker->next)
 	{
 		if (currentthinker->function.acp1 != (actionf_p1)P_MobjThinker)
@@ -3059,7 +3051,7 @@ static void P_RelinkPointers(void)
 	mobj_t *mobj;
 
 	// use info field (value = oldposition) to relink mobjs
-	for (currentthinker = thinkercap.next; currentthinker != &thinkercap;
+	for (currentthinker = thlist[THINK_MOBJ].next; currentthinker != &thlist[THINK_MOBJ];
 		currentthinker = currentthinker->next)
 	{
 		if (currentthinker->function.acp1 != (actionf_p1)P_MobjThinker)
@@ -3497,7 +3489,7 @@ void P_SaveNetGame(savebuffer_t *save, boolean resending)
 	// Assign the mobjnumber for pointer tracking
 	if (gamestate == GS_LEVEL)
 	{
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -3567,6 +3559,7 @@ boolean P_LoadNetGame(savebuffer_t *save, boolean reloading)
 		P_NetUnArchiveWaypoints(save);
 		P_RelinkPointers();
 		P_FinishMobjs();
+		K_UpdatePlayerSnapshot(); // players have new mobjs
 	}
 
 	LUA_UnArchive(save, true);
@@ -39,6 +39,7 @@ typedef struct
 {
 	UINT8 *buffer;
 	UINT8 *p;
+	UINT8 *end; // end of the data, only set when loading a netgame
 } savebuffer_t;
 
 // Persistent storage/archiving.
@@ -727,8 +727,6 @@ static void P_LoadRawSectors(UINT8 *data)
 		ss->lightlevel = SHORT(ms->lightlevel);
 		ss->special = SHORT(ms->special);
 		ss->tag = SHORT(ms->tag);
-		ss->nexttag = ss->firsttag = -1;
-		ss->spawn_nexttag = ss->spawn_firsttag = -1;
 
 		memset(&ss->soundorg, 0, sizeof(ss->soundorg));
 		ss->validcount = 0;
@@ -1119,7 +1117,6 @@ static void P_SetupLines(void)
 
 		ld->frontsector = ld->backsector = NULL;
 		ld->validcount = 0;
-		ld->firsttag = ld->nexttag = -1;
 		ld->callcount = 0;
 
 		// killough 11/98: fix common wad errors (missing sidedefs):
@@ -2153,7 +2150,7 @@ void P_LoadThingsOnly(void)
 	virtres_t* virt = vres_GetMap(lastloadedmaplumpnum);
 	virtlump_t* vth = vres_Find(virt, "THINGS");
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
 	{
 		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
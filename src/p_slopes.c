@@ -22,6 +22,8 @@
 #include "r_main.h"
 #include "p_maputl.h"
 #include "w_wad.h"
+#include "m_jobs.h"
+#include "d_netcmd.h" // cv_threadedlogic
 
 
 static pslope_t *slopelist = NULL;
@@ -144,17 +146,49 @@ static void P_ReconfigureVertexSlope(pslope_t *slope)
 	P_UpdateSlopeLightOffset(slope);
 }
 
-// Recalculate dynamic slopes
-void P_RunDynamicSlopes(void)
+// Line slopes that follow their sectors, built on the first run after a level load
+static pslope_t **planeslopes = NULL;
+static size_t numplaneslopes = 0;
+static UINT16 planeslopesfor = 0;
+
+static void P_BuildPlaneSlopes(void)
 {
 	pslope_t *slope;
 
-	for (slope = slopelist; slope; slope = slope->next) {
-		fixed_t zdelta;
+	if (planeslopes)
+		Z_Free(planeslopes);
+
+	numplaneslopes = 0;
+	planeslopes = Z_Malloc(max(slopecount, 1) * sizeof (*planeslopes), PU_LEVEL, NULL);
 
+	for (slope = slopelist; slope; slope = slope->next)
+	{
 		if (slope->flags & SL_NODYNAMIC)
 			continue;
 
+		if (slope->refpos < 1 || slope->refpos > 5)
+			I_Error("P_RunDynamicSlopes: slope has invalid type!");
+
+		if (slope->refpos != 5)
+			planeslopes[numplaneslopes++] = slope;
+	}
+
+	planeslopesfor = slopecount;
+}
+
+// Each of these only reads sector heights and writes its own slope,
+// so they can be split across the job threads.
+static void P_UpdatePlaneSlopes(void *userdata, size_t start, size_t end)
+{
+	size_t i;
+
+	(void)userdata;
+
+	for (i = start; i < end; i++)
+	{
+		pslope_t *slope = planeslopes[i];
+		fixed_t zdelta;
+
 		switch(slope->refpos) {
 		case 1: // front floor
 			zdelta = slope->sourceline->backsector->floorheight - slope->sourceline->frontsector->floorheight;
@@ -168,32 +202,10 @@ void P_RunDynamicSlopes(void)
 			zdelta = slope->sourceline->frontsector->floorheight - slope->sourceline->backsector->floorheight;
 			slope->o.z = slope->sourceline->backsector->floorheight;
 			break;
-		case 4: // back ceiling
+		default: // back ceiling
 			zdelta = slope->sourceline->frontsector->ceilingheight - slope->sourceline->backsector->ceilingheight;
 			slope->o.z = slope->sourceline->backsector->ceilingheight;
 			break;
-		case 5: // vertices
-			{
-				mapthing_t *mt;
-				size_t i;
-				INT32 l;
-				line_t *line;
-
-				for (i = 0; i < 3; i++) {
-					mt = slope->vertices[i];
-					l = P_FindSpecialLineFromTag(799, mt->angle, -1);
-					if (l != -1) {
-						line = &lines[l];
-						mt->z = line->frontsector->floorheight >> FRACBITS;
-					}
-				}
-
-				P_ReconfigureVertexSlope(slope);
-			}
-			continue; // TODO
-
-		default:
-			I_Error("P_RunDynamicSlopes: slope has invalid type!");
 		}
 
 		if (slope->zdelta != FixedDiv(zdelta, slope->extent)) {
@@ -205,6 +217,44 @@ void P_RunDynamicSlopes(void)
 	}
 }
 
+// Recalculate dynamic slopes
+void P_RunDynamicSlopes(void)
+{
+	pslope_t *slope;
+
+	if (!planeslopes || planeslopesfor != slopecount)
+		P_BuildPlaneSlopes();
+
+#ifdef THREADEDLOGIC
+	if (cv_threadedlogic.value)
+		M_RunJobRange(P_UpdatePlaneSlopes, NULL, numplaneslopes, 128);
+	else
+#endif
+		P_UpdatePlaneSlopes(NULL, 0, numplaneslopes);
+
+	// Vertex slopes can share mapthings, keep them on this thread
+	for (slope = slopelist; slope; slope = slope->next) {
+		mapthing_t *mt;
+		size_t i;
+		INT32 l;
+		line_t *line;
+
+		if (slope->refpos != 5 || (slope->flags & SL_NODYNAMIC))
+			continue;
+
+		for (i = 0; i < 3; i++) {
+			mt = slope->vertices[i];
+			l = P_FindSpecialLineFromTag(799, mt->angle, -1);
+			if (l != -1) {
+				line = &lines[l];
+				mt->z = line->frontsector->floorheight >> FRACBITS;
+			}
+		}
+
+		P_ReconfigureVertexSlope(slope);
+	}
+}
+
 //
 // P_MakeSlope
 //
@@ -687,6 +737,7 @@ void P_ResetDynamicSlopes(void)
 
 	slopelist = NULL;
 	slopecount = 0;
+	planeslopes = NULL; // went with the last level
 
 	// We'll handle copy slopes later, after all the tag lists have been made.
 	// Yes, this means copied slopes won't affect things' spawning heights. Too bad for you.
@@ -0,0 +1,108 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2023 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  p_tags.c
+/// \brief Tag to sector/line lookup tables
+///
+///        Every tag in use has a sorted array of the sectors or lines that
+///        have it, so a search only looks at what it finds, in the same
+///        order the old hash chains gave. The arrays are level data, the
+///        zone frees them on the next map load.
+
+#include "doomdef.h"
+#include "p_tags.h"
+#include "z_zone.h"
+
+taggroup_t *tags_sectors[MAXTAGS];
+taggroup_t *tags_lines[MAXTAGS];
+
+void Tag_Reset(void)
+{
+	memset(tags_sectors, 0, sizeof (tags_sectors));
+	memset(tags_lines, 0, sizeof (tags_lines));
+}
+
+// Position of the first element greater than or equal to id.
+static size_t Tag_Search(const taggroup_t *group, INT32 id)
+{
+	size_t lo = 0, hi = group->count;
+
+	while (lo < hi)
+	{
+		size_t mid = lo + (hi - lo)/2;
+		if (group->elements[mid] < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+void Tag_Add(taggroup_t *garray[], INT16 tag, INT32 id)
+{
+	taggroup_t *group = garray[(UINT16)tag];
+	size_t i;
+
+	if (!group)
+		group = garray[(UINT16)tag] = Z_Calloc(sizeof (*group), PU_LEVEL, NULL);
+
+	// Levels add in increasing order, skip the search then
+	if (!group->count || group->elements[group->count - 1] < id)
+		i = group->count;
+	else
+	{
+		i = Tag_Search(group, id);
+		if (group->elements[i] == id)
+			return;
+	}
+
+	if (group->count == group->capacity)
+	{
+		group->capacity = group->capacity ? group->capacity*2 : 4;
+		group->elements = Z_Realloc(group->elements, group->capacity * sizeof (*group->elements), PU_LEVEL, NULL);
+	}
+
+	memmove(&group->elements[i + 1], &group->elements[i], (group->count - i) * sizeof (*group->elements));
+	group->elements[i] = id;
+	group->count++;
+}
+
+void Tag_Remove(taggroup_t *garray[], INT16 tag, INT32 id)
+{
+	taggroup_t *group = garray[(UINT16)tag];
+	size_t i;
+
+	if (!group)
+		return;
+
+	i = Tag_Search(group, id);
+	if (i == group->count || group->elements[i] != id)
+		return;
+
+	group->count--;
+	memmove(&group->elements[i], &group->elements[i + 1], (group->count - i) * sizeof (*group->elements));
+}
+
+INT32 Tag_Next(taggroup_t *const garray[], INT16 tag, INT32 start)
+{
+	const taggroup_t *group = garray[(UINT16)tag];
+	size_t i;
+
+	if (!group)
+		return -1;
+
+	i = (start < 0) ? 0 : Tag_Search(group, start + 1);
+	return (i < group->count) ? group->elements[i] : -1;
+}
+
+size_t Tag_Count(taggroup_t *const garray[], INT16 tag)
+{
+	const taggroup_t *group = garray[(UINT16)tag];
+	return group ? group->count : 0;
+}
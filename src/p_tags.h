@@ -0,0 +1,43 @@
+// SONIC ROBO BLAST 2 KART
+//-----------------------------------------------------------------------------
+// Copyright (C) 2023 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  p_tags.h
+/// \brief Tag to sector/line lookup tables
+
+#ifndef __P_TAGS__
+#define __P_TAGS__
+
+#include "doomtype.h"
+
+#define MAXTAGS 65536 // every INT16 value
+
+// All the elements with one tag, in increasing order.
+typedef struct
+{
+	INT32 *elements;
+	size_t count;
+	size_t capacity;
+} taggroup_t;
+
+// Indexed by (UINT16)tag, NULL if nothing has that tag.
+extern taggroup_t *tags_sectors[MAXTAGS];
+extern taggroup_t *tags_lines[MAXTAGS];
+
+// Empties the tables for a new level.
+void Tag_Reset(void);
+
+void Tag_Add(taggroup_t *garray[], INT16 tag, INT32 id);
+void Tag_Remove(taggroup_t *garray[], INT16 tag, INT32 id);
+
+// Returns the first element with this tag after start (-1 to start anew), or -1 if there is none.
+INT32 Tag_Next(taggroup_t *const garray[], INT16 tag, INT32 start);
+
+// How many elements have this tag.
+size_t Tag_Count(taggroup_t *const garray[], INT16 tag);
+
+#endif
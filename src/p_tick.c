@@ -30,6 +30,7 @@
 #include "r_fps.h"
 #include "i_video.h" // rendermode
 #include "m_perfstats.h"
+#include "d_netcmd.h" // cv_perfstats
 
 // Object place
 #include "m_cheat.h"
@@ -47,8 +48,13 @@ tic_t leveltime;
 // but the first element must be thinker_t.
 //
 
-// Both the head and tail of the thinker list.
-thinker_t thinkercap;
+// Both the head and tail of each thinker list.
+thinker_t thlist[NUM_THINKERLISTS];
+
+// Both the head and tail of the order thinkers run in. Every list but
+// precipitation runs as one, in the order the thinkers were added, the
+// same order as when there was only one list.
+thinker_t thinkrun;
 
 void Command_Numthinkers_f(void)
 {
@@ -104,7 +110,7 @@ void Command_Numthinkers_f(void)
 			return;
 	}
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	for (think = P_NextThinker(&thlist[0], NUM_THINKERLISTS-1); think; think = P_NextThinker(think, NUM_THINKERLISTS-1))
 	{
 		if (think->function.acp1 != action)
 			continue;
@@ -141,7 +147,7 @@ void Command_CountMobjs_f(void)
 
 			count = 0;
 
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 			{
 				if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 					continue;
@@ -161,7 +167,7 @@ void Command_CountMobjs_f(void)
 	{
 		count = 0;
 
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
 		{
 			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
 				continue;
@@ -180,24 +186,86 @@ void Command_CountMobjs_f(void)
 //
 void P_InitThinkers(void)
 {
-	thinkercap.prev = thinkercap.next = &thinkercap;
+	UINT8 i;
+	for (i = 0; i < NUM_THINKERLISTS; i++)
+		thlist[i].prev = thlist[i].next = &thlist[i];
+	thinkrun.runprev = thinkrun.runnext = &thinkrun;
 	waypointcap = NULL;
+	K_ClearWaypointIndex();
 }
 
 //
 // P_AddThinker
-// Adds a new thinker at the end of the list.
+// Adds a new thinker at the end of a list, and of the run order.
 //
-void P_AddThinker(thinker_t *thinker)
+void P_AddThinker(const thinklistnum_t n, thinker_t *thinker)
 {
-	thinkercap.prev->next = thinker;
-	thinker->next = &thinkercap;
-	thinker->prev = thinkercap.prev;
-	thinkercap.prev = thinker;
+	thlist[n].prev->next = thinker;
+	thinker->next = &thlist[n];
+	thinker->prev = thlist[n].prev;
+	thlist[n].prev = thinker;
+	thinker->list = (UINT8)n;
+
+	if (n == THINK_PRECIP) // never runs
+		thinker->runprev = thinker->runnext = NULL;
+	else
+	{
+		thinkrun.runprev->runnext = thinker;
+		thinker->runnext = &thinkrun;
+		thinker->runprev = thinkrun.runprev;
+		thinkrun.runprev = thinker;
+	}
+
+	thinker->references = 0;    // killough 11/98: init reference counter to 0
+}
+
+//
+// P_AddThinkerFirst
+// Adds a new thinker at the start of a list, and of the run order.
+//
+void P_AddThinkerFirst(const thinklistnum_t n, thinker_t *thinker)
+{
+	I_Assert(n != THINK_PRECIP);
+
+	thlist[n].next->prev = thinker;
+	thinker->next = thlist[n].next;
+	thinker->prev = &thlist[n];
+	thlist[n].next = thinker;
+	thinker->list = (UINT8)n;
+
+	thinkrun.runnext->runprev = thinker;
+	thinker->runnext = thinkrun.runnext;
+	thinker->runprev = &thinkrun;
+	thinkrun.runnext = thinker;
 
 	thinker->references = 0;    // killough 11/98: init reference counter to 0
 }
 
+//
+// P_NextThinker
+// Returns the thinker after th, going on to the next lists up to last,
+// or NULL after the end. Pass a list head as th to start from that list:
+//
+// for (th = P_NextThinker(&thlist[first], last); th; th = P_NextThinker(th, last))
+//
+thinker_t *P_NextThinker(const thinker_t *th, thinklistnum_t last)
+{
+	thinker_t *next = th->next;
+	UINT8 i;
+
+	// Lists are in order, so this also skips empty ones
+	for (i = 0; i < NUM_THINKERLISTS; i++)
+	{
+		if (next != &thlist[i])
+			continue;
+		if (i >= last)
+			return NULL;
+		next = thlist[i + 1].next;
+	}
+
+	return next;
+}
+
 //
 // killough 11/98:
 //
@@ -227,13 +295,15 @@ void P_RemoveThinkerDelayed(thinker_t *thinker)
 	if (thinker->references)
 		return;
 
-	/* Remove from main thinker list */
+	/* Remove from its thinker list */
 	thinker_t *next = thinker->next;
+	(next->prev = thinker->prev)->next = next;
 	/* Note that currentthinker is guaranteed to point to us,
 	* and since we're freeing our memory, we had better change that. So
-	* point it to thinker->prev, so the iterator will correctly move on to
-	* thinker->prev->next = thinker->next */
-	(next->prev = currentthinker = thinker->prev)->next = next;
+	* point it to thinker->runprev, so the iterator will correctly move on to
+	* thinker->runprev->runnext = thinker->runnext */
+	next = thinker->runnext;
+	(next->runprev = currentthinker = thinker->runprev)->runnext = next;
 	R_DestroyLevelInterpolators(thinker);
 	Z_Free(thinker);
 }
@@ -250,6 +320,11 @@ void P_UnlinkThinker(thinker_t *thinker)
 	I_Assert(thinker->references == 0);
 
 	(next->prev = thinker->prev)->next = next;
+	if (thinker->runnext)
+	{
+		next = thinker->runnext;
+		(next->runprev = thinker->runprev)->runnext = next;
+	}
 	Z_Free(thinker);
 }
 
@@ -314,17 +389,52 @@ mobj_t *P_SetTarget(mobj_t **mop, mobj_t *targ)
 // Rewritten to delete nodes implicitly, by making currentthinker
 // external and using P_RemoveThinkerDelayed() implicitly.
 //
+// The lists are only for finding thinkers of one kind; they all run
+// together in the order they were added, so demos and netgames play out
+// exactly as with a single list. Precipitation doesn't think.
+//
+// On the logic perfstats page, each list's time is summed as well. The
+// clock is only read where the run order switches lists.
+//
 static inline void P_RunThinkers(void)
 {
-	for (currentthinker = thinkercap.next; currentthinker != &thinkercap; currentthinker = currentthinker->next)
+	UINT8 list = NUM_THINKERLISTS;
+	precise_t start = 0;
+
+	if (cv_perfstats.value != 2)
+	{
+		for (currentthinker = thinkrun.runnext; currentthinker != &thinkrun; currentthinker = currentthinker->runnext)
+		{
+#ifdef PARANOIA
+			I_Assert(currentthinker->function.acp1 != NULL)
+#endif
+			currentthinker->function.acp1(currentthinker);
+		}
+		return;
+	}
+
+	for (list = 0; list < NUM_THINKERLISTS; list++)
+		ps_thlist_times[list].value.p = 0;
+
+	for (currentthinker = thinkrun.runnext; currentthinker != &thinkrun; currentthinker = currentthinker->runnext)
 	{
-		if (currentthinker->function.acp1 == (actionf_p1)P_NullPrecipThinker)
-			continue;
 #ifdef PARANOIA
 		I_Assert(currentthinker->function.acp1 != NULL)
 #endif
+		if (currentthinker->list != list)
+		{
+			precise_t now = I_GetPreciseTime();
+			if (list < NUM_THINKERLISTS)
+				ps_thlist_times[list].value.p += now - start;
+			list = currentthinker->list;
+			start = now;
+		}
+
 		currentthinker->function.acp1(currentthinker);
 	}
+
+	if (list < NUM_THINKERLISTS)
+		ps_thlist_times[list].value.p += I_GetPreciseTime() - start;
 }
 
 static inline void P_DeviceRumbleTick(void)
@@ -434,6 +544,8 @@ void P_Ticker(boolean run)
 {
 	INT32 i;
 
+	K_UpdatePlayerSnapshot();
+
 	//Increment jointime even if paused.
 	for (i = 0; i < MAXPLAYERS; i++)
 		if (playeringame[i])
@@ -517,6 +629,7 @@ void P_Ticker(boolean run)
 		}
 		
 		ps_lua_mobjhooks.value.i = 0;
+		ps_lua_allocs.value.i = 0;
 		ps_checkposition_calls.value.i = 0;
 
 		PS_START_TIMING(ps_lua_prethinkframe_time);
@@ -536,10 +649,13 @@ void P_Ticker(boolean run)
 
 	if (run)
 	{
+		PS_START_TIMING(ps_thinkertime);
+
 		// Dynamic slopeness
+		PS_START_TIMING(ps_dynslopes_time);
 		P_RunDynamicSlopes();
+		PS_STOP_TIMING(ps_dynslopes_time);
 
-		PS_START_TIMING(ps_thinkertime);
 		P_RunThinkers();
 		PS_STOP_TIMING(ps_thinkertime);
 
@@ -699,6 +815,9 @@ void P_Ticker(boolean run)
 
 	if (demo.playback)
 		G_StoreRewindInfo();
+
+	// Collect Lua garbage now rather than in the middle of next tic's hooks
+	LUA_GCTic();
 }
 
 // Abbreviated ticker for pre-loading, calls thinkers and assorted things
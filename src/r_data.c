@@ -1623,6 +1623,48 @@ INT32 R_TextureNumForName(const char *name)
 //
 // Preloads all relevant graphics for the level.
 //
+// Starts decompressing everything R_PrecacheLevel is about to cache
+// on the job threads, so it only has to wait for what isn't done yet.
+static void R_PrefetchLevel(const char *texturepresent, const char *spritepresent)
+{
+	lumpnum_t *lumps;
+	size_t numlumps = numlevelflats;
+	size_t i, j, k;
+
+	for (i = 0; i < (unsigned)numtextures; i++)
+		if (texturepresent[i] && !texturecache[i])
+			numlumps += textures[i]->patchcount;
+	for (i = 0; i < numsprites; i++)
+		if (spritepresent[i])
+			numlumps += sprites[i].numframes * 8;
+
+	lumps = malloc(numlumps * sizeof (*lumps));
+	if (lumps == NULL)
+		return; // not worth failing over, everything still gets read later
+
+	numlumps = 0;
+	for (i = 0; i < numlevelflats; i++)
+		lumps[numlumps++] = levelflats[i].lumpnum;
+	for (i = 0; i < (unsigned)numtextures; i++)
+	{
+		if (!texturepresent[i] || texturecache[i])
+			continue;
+		for (j = 0; j < (unsigned)textures[i]->patchcount; j++)
+			lumps[numlumps++] = (textures[i]->patches[j].wad<<16) + textures[i]->patches[j].lump;
+	}
+	for (i = 0; i < numsprites; i++)
+	{
+		if (!spritepresent[i])
+			continue;
+		for (j = 0; j < sprites[i].numframes; j++)
+			for (k = 0; k < 8; k++)
+				lumps[numlumps++] = sprites[i].spriteframes[j].lumppat[k];
+	}
+
+	W_PrefetchLumps(lumps, numlumps);
+	free(lumps);
+}
+
 void R_PrecacheLevel(void)
 {
 	char *texturepresent, *spritepresent;
@@ -1639,11 +1681,8 @@ void R_PrecacheLevel(void)
 	if (rendermode != render_soft)
 		return;
 
-	// Precache flats.
-	flatmemory = P_PrecacheLevelFlats();
-
 	//
-	// Precache textures.
+	// Find the textures and sprites in use.
 	//
 	// no need to precache all software textures in 3D mode
 	// (note they are still used with the reference software view)
@@ -1666,6 +1705,21 @@ void R_PrecacheLevel(void)
 	// while the sky texture is stored like a wall texture, with a skynum dependent name.
 	texturepresent[skytexture] = 1;
 
+	spritepresent = calloc(numsprites, sizeof (*spritepresent));
+	if (spritepresent == NULL) I_Error("%s: Out of memory looking up sprites", "R_PrecacheLevel");
+
+	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
+			spritepresent[((mobj_t *)th)->sprite] = 1;
+
+	R_PrefetchLevel(texturepresent, spritepresent);
+
+	// Precache flats.
+	flatmemory = P_PrecacheLevelFlats();
+
+	//
+	// Precache textures.
+	//
 	texturememory = 0;
 	for (j = 0; j < (unsigned)numtextures; j++)
 	{
@@ -1682,13 +1736,6 @@ void R_PrecacheLevel(void)
 	//
 	// Precache sprites.
 	//
-	spritepresent = calloc(numsprites, sizeof (*spritepresent));
-	if (spritepresent == NULL) I_Error("%s: Out of memory looking up sprites", "R_PrecacheLevel");
-
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
-		if (th->function.acp1 == (actionf_p1)P_MobjThinker)
-			spritepresent[((mobj_t *)th)->sprite] = 1;
-
 	spritememory = 0;
 	for (i = 0; i < numsprites; i++)
 	{
@@ -1710,6 +1757,9 @@ void R_PrecacheLevel(void)
 	}
 	free(spritepresent);
 
+	// Whatever wasn't asked for after all just stays cached.
+	W_FinishPrefetches();
+
 	// FIXME: this is no longer correct with OpenGL render mode
 	CONS_Debug(DBG_SETUP, "Precache level done:\n"
 			"flatmemory:    %s k\n"
@@ -285,7 +285,6 @@ typedef struct sector_s
 	INT16 lightlevel;
 	INT16 special;
 	UINT16 tag;
-	INT32 nexttag, firsttag; // for fast tag searches
 
 	// origin for any sounds played by the sector
 	// also considered the center for e.g. Mario blocks
@@ -363,8 +362,6 @@ typedef struct sector_s
 	boolean hasslope; // The sector, or one of its visible FOFs, contains a slope
 
 	// these are saved for netgames, so do not let Lua touch these!
-	INT32 spawn_nexttag, spawn_firsttag; // the actual nexttag/firsttag values may differ if the sector's tag was changed
-
 	// offsets sector spawned with (via linedef type 7)
 	fixed_t spawn_flr_xoffs, spawn_flr_yoffs;
 	fixed_t spawn_ceil_xoffs, spawn_ceil_yoffs;
@@ -417,7 +414,6 @@ typedef struct line_s
 #if 1//#ifdef WALLSPLATS
 	void *splats; // wallsplat_t list
 #endif
-	INT32 firsttag, nexttag; // improves searches for tags.
 	polyobj_t *polyobj; // Belongs to a polyobject?
 
 	char *text; // a concatination of all front and back texture names, for linedef specials that require a string.
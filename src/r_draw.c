@@ -21,6 +21,7 @@
 #include "r_things.h"
 #include "st_stuff.h" // need ST_HEIGHT
 #include "i_video.h"
+#include "i_system.h" // I_GetPreciseTime
 #include "v_video.h"
 #include "m_misc.h"
 #include "w_wad.h"
@@ -32,6 +33,13 @@
 #include "hardware/hw_main.h"
 #endif
 
+// Vector flat offsets for the span drawers, SSE2 is part of the base
+// instruction set of x86-64.
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SPANSTEPPER
+#endif
+
 // ==========================================================================
 //                     COMMON DATA FOR 8bpp AND 16bpp
 // ==========================================================================
@@ -578,6 +578,45 @@ void R_DrawTranslatedColumn_8(void)
 // <Callum> 4194303 = (2048x2048)-1 (2048x2048 is maximum flat size)
 #define MAXFLATBYTES 4194303
 
+#ifdef SPANSTEPPER
+// Steps four span pixels at a time and works out their flat offsets, the
+// same wrapping integer math as the scalar loops so the output is exact.
+typedef struct
+{
+	__m128i x, y, xstep, ystep;
+	__m128i xshift, yshift, mask;
+} spanstepper_t;
+
+static inline void R_InitSpanStepper(spanstepper_t *st, fixed_t xposition, fixed_t yposition, fixed_t xstep, fixed_t ystep)
+{
+	const UINT32 xs = (UINT32)xstep, ys = (UINT32)ystep;
+	const UINT32 xp = (UINT32)xposition, yp = (UINT32)yposition;
+	st->x = _mm_set_epi32((INT32)(xp + xs*3), (INT32)(xp + xs*2), (INT32)(xp + xs), (INT32)xp);
+	st->y = _mm_set_epi32((INT32)(yp + ys*3), (INT32)(yp + ys*2), (INT32)(yp + ys), (INT32)yp);
+	st->xstep = _mm_set1_epi32((INT32)(xs*4));
+	st->ystep = _mm_set1_epi32((INT32)(ys*4));
+	st->xshift = _mm_cvtsi32_si128((INT32)nflatxshift);
+	st->yshift = _mm_cvtsi32_si128((INT32)nflatyshift);
+	st->mask = _mm_set1_epi32((INT32)nflatmask);
+}
+
+// Writes the flat offsets of the next eight pixels.
+static inline void R_StepSpan8(spanstepper_t *st, UINT32 *bits)
+{
+	INT32 half;
+
+	for (half = 0; half < 2; half++)
+	{
+		__m128i b = _mm_or_si128(
+			_mm_and_si128(_mm_srl_epi32(st->y, st->yshift), st->mask),
+			_mm_srl_epi32(st->x, st->xshift));
+		_mm_storeu_si128((__m128i *)&bits[half*4], b);
+		st->x = _mm_add_epi32(st->x, st->xstep);
+		st->y = _mm_add_epi32(st->y, st->ystep);
+	}
+}
+#endif
+
 /**	\brief The R_DrawSpan_8 function
 	Draws the actual span.
 */
@@ -616,6 +655,27 @@ void R_DrawSpan_8 (void)
 	if (dest+8 > deststop)
 		return;
 
+#ifdef SPANSTEPPER
+	if (count >= 8)
+	{
+		spanstepper_t st;
+		UINT32 bits[8];
+
+		R_InitSpanStepper(&st, xposition, yposition, xstep, ystep);
+
+		while (count >= 8)
+		{
+			R_StepSpan8(&st, bits);
+			for (i = 0; i < 8; i++)
+				dest[i] = colormap[source[bits[i]]];
+
+			xposition += xstep*8;
+			yposition += ystep*8;
+			dest += 8;
+			count -= 8;
+		}
+	}
+#else
 	while (count >= 8)
 	{
 		// SoM: Why didn't I see this earlier? the spot variable is a waste now because we don't
@@ -633,6 +693,7 @@ void R_DrawSpan_8 (void)
 		dest += 8;
 		count -= 8;
 	}
+#endif
 	while (count-- && dest <= deststop)
 	{
 		bit = (((UINT32)yposition >> nflatyshift) & nflatmask) | ((UINT32)xposition >> nflatxshift);
@@ -643,6 +704,116 @@ void R_DrawSpan_8 (void)
 	}
 }
 
+#define BENCHSPANS 4096
+#define BENCHRUNS 8
+
+// Sets up the i-th span of the benchmark, a spread of lengths and steps.
+static void R_BenchSpanSetup(INT32 i)
+{
+	ds_y = ds_x1 = 0;
+	ds_x2 = viewwidth - 1 - (i & 7);
+	ds_xfrac = i * 0x1357;
+	ds_yfrac = i * -0x2468;
+	ds_xstep = FRACUNIT/2 + (i & 63) * 0x321;
+	ds_ystep = (i & 31) * -0x123;
+}
+
+// The scalar loop R_DrawSpan_8 uses without SPANSTEPPER, for comparison.
+static void R_BenchSpanScalar(UINT8 *dest)
+{
+	UINT32 xposition = (UINT32)ds_xfrac << nflatshiftup, yposition = (UINT32)ds_yfrac << nflatshiftup;
+	UINT32 xstep = (UINT32)ds_xstep << nflatshiftup, ystep = (UINT32)ds_ystep << nflatshiftup;
+	size_t count = (ds_x2 - ds_x1 + 1);
+
+	while (count--)
+	{
+		*dest++ = ds_colormap[ds_source[((yposition >> nflatyshift) & nflatmask) | (xposition >> nflatxshift)]];
+		xposition += xstep;
+		yposition += ystep;
+	}
+}
+
+/**	\brief Times R_DrawSpan_8 against the scalar span loop
+
+	Draws the same spans over a 64x64 flat with both, checks that they
+	agree and prints the best time per pixel of a few runs. The spans go
+	to the top row of the view, which the next frame redraws.
+*/
+void R_BenchmarkSpans(void)
+{
+	static UINT8 flat[64*64];
+	static UINT8 colormap[256];
+	UINT8 *reference;
+	double precision = I_GetPrecisePrecision() / 1000000000.0; // nanoseconds
+	precise_t vector = UINT64_MAX, scalar = UINT64_MAX;
+	INT32 i, run;
+	boolean same = true;
+
+	if (rendermode != render_soft || !screens[0])
+	{
+		CONS_Printf(M_GetText("benchspans only works in the software renderer.\n"));
+		return;
+	}
+
+#ifndef SPANSTEPPER
+	CONS_Printf(M_GetText("This build has no vector span stepper, both loops are scalar.\n"));
+#endif
+
+	reference = malloc(viewwidth);
+	if (!reference)
+		return;
+
+	for (i = 0; i < 64*64; i++)
+		flat[i] = (UINT8)(i * 7 + (i >> 6));
+	for (i = 0; i < 256; i++)
+		colormap[i] = (UINT8)(255 - i);
+
+	ds_source = flat;
+	ds_colormap = colormap;
+	nflatmask = 0xFC0;
+	nflatxshift = 26;
+	nflatyshift = 20;
+	nflatshiftup = 10;
+
+	for (i = 0; i < BENCHSPANS && same; i++)
+	{
+		R_BenchSpanSetup(i);
+		R_DrawSpan_8();
+		R_BenchSpanScalar(reference);
+		same = !memcmp(reference, ylookup[0] + columnofs[0], ds_x2 + 1);
+	}
+
+	for (run = 0; run < BENCHRUNS; run++)
+	{
+		precise_t start = I_GetPreciseTime();
+		for (i = 0; i < BENCHSPANS; i++)
+		{
+			R_BenchSpanSetup(i);
+			R_DrawSpan_8();
+		}
+		vector = min(vector, I_GetPreciseTime() - start);
+
+		start = I_GetPreciseTime();
+		for (i = 0; i < BENCHSPANS; i++)
+		{
+			R_BenchSpanSetup(i);
+			R_BenchSpanScalar(reference);
+		}
+		scalar = min(scalar, I_GetPreciseTime() - start);
+	}
+
+	CONS_Printf("%d spans of about %d pixels, best of %d runs:\n", BENCHSPANS, viewwidth, BENCHRUNS);
+	CONS_Printf("R_DrawSpan_8 %8.3f ns/pixel\n", vector / precision / BENCHSPANS / viewwidth);
+	CONS_Printf("Scalar loop  %8.3f ns/pixel\n", scalar / precision / BENCHSPANS / viewwidth);
+	if (!same)
+		CONS_Printf("\x85" "The two loops drew different pixels!\n");
+
+	free(reference);
+}
+
+#undef BENCHSPANS
+#undef BENCHRUNS
+
 // R_CalcTiltedLighting
 // Exactly what it says on the tin. I wish I wasn't too lazy to explain things properly.
 static INT32 tiltlighting[MAXVIDWIDTH];
@@ -1419,6 +1590,27 @@ void R_DrawTranslucentSpan_8 (void)
 	colormap = ds_colormap;
 	dest = ylookup[ds_y] + columnofs[ds_x1];
 
+#ifdef SPANSTEPPER
+	if (count >= 8)
+	{
+		spanstepper_t st;
+		UINT32 bits[8];
+
+		R_InitSpanStepper(&st, xposition, yposition, xstep, ystep);
+
+		while (count >= 8)
+		{
+			R_StepSpan8(&st, bits);
+			for (i = 0; i < 8; i++)
+				dest[i] = *(ds_transmap + (colormap[source[bits[i]]] << 8) + dest[i]);
+
+			xposition += xstep*8;
+			yposition += ystep*8;
+			dest += 8;
+			count -= 8;
+		}
+	}
+#else
 	while (count >= 8)
 	{
 		// SoM: Why didn't I see this earlier? the spot variable is a waste now because we don't
@@ -1435,6 +1627,7 @@ void R_DrawTranslucentSpan_8 (void)
 		dest += 8;
 		count -= 8;
 	}
+#endif
 	while (count-- && dest <= deststop)
 	{
 		bit = (((UINT32)yposition >> nflatyshift) & nflatmask) | ((UINT32)xposition >> nflatxshift);
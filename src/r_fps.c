@@ -23,6 +23,8 @@
 #include "r_state.h"
 #include "z_zone.h"
 #include "console.h" // con_startup_loadprogress
+#include "d_netcmd.h" // cv_threadedlogic
+#include "m_jobs.h"
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h" // for cv_grshearing
@@ -539,11 +541,13 @@ static void UpdateLevelInterpolatorState(levelinterpolator_t *interp)
 	}
 }
 
-void R_UpdateLevelInterpolators(void)
+static void UpdateLevelInterpolatorRange(void *userdata, size_t start, size_t end)
 {
 	size_t i;
 
-	for (i = 0; i < levelinterpolators_len; i++)
+	(void)userdata;
+
+	for (i = start; i < end; i++)
 	{
 		levelinterpolator_t *interp = levelinterpolators[i];
 
@@ -551,6 +555,17 @@ void R_UpdateLevelInterpolators(void)
 	}
 }
 
+void R_UpdateLevelInterpolators(void)
+{
+	// Every interpolator only touches its own state
+#ifdef THREADEDLOGIC
+	if (cv_threadedlogic.value)
+		M_RunJobRange(UpdateLevelInterpolatorRange, NULL, levelinterpolators_len, 512);
+	else
+#endif
+		UpdateLevelInterpolatorRange(NULL, 0, levelinterpolators_len);
+}
+
 void R_ClearLevelInterpolatorState(thinker_t *thinker)
 {
 	size_t i;
@@ -756,10 +771,13 @@ void R_InitMobjInterpolators(void)
 	interpolated_mobjs_capacity = 0;
 }
 
-void R_UpdateMobjInterpolators(void)
+static void UpdateMobjInterpolatorRange(void *userdata, size_t start, size_t end)
 {
 	size_t i;
-	for (i = 0; i < interpolated_mobjs_len; i++)
+
+	(void)userdata;
+
+	for (i = start; i < end; i++)
 	{
 		mobj_t *mobj = interpolated_mobjs[i];
 		if (!P_MobjWasRemoved(mobj))
@@ -767,6 +785,17 @@ void R_UpdateMobjInterpolators(void)
 	}
 }
 
+void R_UpdateMobjInterpolators(void)
+{
+	// Each mobj is in the list once, so the ranges never share one
+#ifdef THREADEDLOGIC
+	if (cv_threadedlogic.value)
+		M_RunJobRange(UpdateMobjInterpolatorRange, NULL, interpolated_mobjs_len, 1024);
+	else
+#endif
+		UpdateMobjInterpolatorRange(NULL, 0, interpolated_mobjs_len);
+}
+
 //
 // P_ResetMobjInterpolationState
 //
@@ -34,6 +34,7 @@
 #include "doomstat.h" // MAXSPLITSCREENPLAYERS
 #include "r_fps.h" // Frame interpolation/uncapped
 #include "tables.h"
+#include "m_jobs.h"
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -107,6 +108,7 @@ extracolormap_t extra_colormaps[MAXCOLORMAPS];
 // Performance stats
 precise_t ps_prevframetime = 0;
 ps_metric_t ps_rendercalltime = {0};
+ps_metric_t ps_viewtimes[MAXSPLITSCREENPLAYERS];
 ps_metric_t ps_otherrendertime = {0};
 ps_metric_t ps_uitime = {0};
 ps_metric_t ps_swaptime = {0};
@@ -123,6 +125,9 @@ ps_metric_t ps_numbspcalls = {0};
 ps_metric_t ps_numsprites = {0};
 ps_metric_t ps_numdrawnodes = {0};
 ps_metric_t ps_numpolyobjects = {0};
+ps_metric_t ps_numvisplanes = {0};
+ps_metric_t ps_numplanemerges = {0};
+ps_metric_t ps_numslopevectors = {0};
 
 static CV_PossibleValue_t drawdist_cons_t[] = {
 	/*{256, "256"},*/	{512, "512"},	{768, "768"},
@@ -198,6 +203,8 @@ consvar_t cv_grmaxinterpdist = {"gr_maxinterpdist", "Infinite", CV_SAVE, maxinte
 
 consvar_t cv_ripplewater = {"waterripples", "On", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 
+consvar_t cv_threadedpostprocess = {"threadedpostprocess", "Off", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+
 // cap fov, fov too high tears software apart.
 consvar_t cv_fov = {"fov", "90", CV_FLOAT|CV_CALL|CV_SAVE, fov_cons_t, Fov_OnChange, 0, NULL, NULL, 0, 0, NULL};
 
@@ -285,7 +292,7 @@ static void Precipstuff_OnChange(void)
 	thinker_t *next;
 	precipmobj_t *precipmobj;
 
-	for (think = thinkercap.next; think != &thinkercap; think = next)
+	for (think = thlist[THINK_PRECIP].next; think != &thlist[THINK_PRECIP]; think = next)
 	{
 		next = think->next;
 
@@ -840,6 +847,19 @@ void R_CheckViewMorph(void)
 	viewmorph.use = true;
 }
 
+// Remaps rows [start, end) of the view, each row only reads screens[0].
+static void R_ViewMorphRows(void *userdata, size_t start, size_t end)
+{
+	UINT8 *tmpscr = screens[4];
+	const UINT8 *srcscr = screens[0];
+	size_t p;
+
+	(void)userdata;
+
+	for (p = start * vid.width; p < end * vid.width; p++)
+		tmpscr[p] = srcscr[viewmorph.scrmap[p]];
+}
+
 void R_ApplyViewMorph(void)
 {
 	UINT8 *tmpscr = screens[4];
@@ -874,9 +894,10 @@ void R_ApplyViewMorph(void)
 			tmpscr[viewmorph.scrmap[end - 1 - p]] = border;
 		}
 	}
+	else if (cv_threadedpostprocess.value)
+		M_RunJobRange(R_ViewMorphRows, NULL, vid.height, 64);
 	else
-		for (p = 0; p < end; p++)
-			tmpscr[p] = srcscr[viewmorph.scrmap[p]];
+		R_ViewMorphRows(NULL, 0, vid.height);
 
 	VID_BlitLinearScreen(tmpscr, screens[0],
 			vid.width*vid.bpp, vid.height, vid.width*vid.bpp, vid.width);
@@ -1763,6 +1784,7 @@ void R_RenderPlayerView(player_t *player)
 	// The head node is the last node output.
 
 	ps_numbspcalls.value.i = ps_numpolyobjects.value.i = ps_numdrawnodes.value.i = 0;
+	ps_numvisplanes.value.i = ps_numplanemerges.value.i = ps_numslopevectors.value.i = 0;
 	PS_START_TIMING(ps_bsptime);
 	R_RenderBSPNode((INT32)numnodes - 1);
 	PS_STOP_TIMING(ps_bsptime);
@@ -1849,10 +1871,13 @@ void R_RegisterEngineStuff(void)
 	if (dedicated)
 		return;
 
+	COM_AddCommand("benchspans", R_BenchmarkSpans);
+
 	CV_RegisterVar(&cv_translucency);
 	CV_RegisterVar(&cv_drawdist);
 	CV_RegisterVar(&cv_drawdist_precip);
 	CV_RegisterVar(&cv_lessprecip);
+	CV_RegisterVar(&cv_threadedpostprocess);
 	CV_RegisterVar(&cv_mobjscaleprecip);
 	CV_RegisterVar(&cv_fov);
 
@@ -115,6 +115,7 @@ typedef struct portal_pair
 // Performance stats
 extern precise_t ps_prevframetime;// time when previous frame was rendered
 extern ps_metric_t ps_rendercalltime;
+extern ps_metric_t ps_viewtimes[MAXSPLITSCREENPLAYERS]; // each splitscreen view on its own, skybox included
 extern ps_metric_t ps_otherrendertime;
 extern ps_metric_t ps_uitime;
 extern ps_metric_t ps_swaptime;
@@ -131,6 +132,9 @@ extern ps_metric_t ps_numbspcalls;
 extern ps_metric_t ps_numsprites;
 extern ps_metric_t ps_numdrawnodes;
 extern ps_metric_t ps_numpolyobjects;
+extern ps_metric_t ps_numvisplanes;
+extern ps_metric_t ps_numplanemerges;
+extern ps_metric_t ps_numslopevectors;
 
 //
 // REFRESH - the actual rendering functions.
@@ -149,6 +153,7 @@ extern consvar_t cv_skybox;
 extern consvar_t cv_tailspickup;
 extern consvar_t cv_grmaxinterpdist;
 extern consvar_t cv_ripplewater;
+extern consvar_t cv_threadedpostprocess;
 
 // Called by startup code.
 void R_Init(void);
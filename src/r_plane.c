@@ -103,6 +103,26 @@ fixed_t cachedystep[MAXVIDHEIGHT];
 
 static fixed_t xoffs, yoffs;
 
+// Slope vectors worked out this frame. Split planes of the same slope all
+// ask for the same ones, so only the first has to do the float math.
+#define SLOPEVECCACHESIZE 64
+
+typedef struct
+{
+	UINT32 frame;
+	pslope_t *slope;
+	fixed_t viewx, viewy, viewz;
+	fixed_t xoffset, yoffset;
+	angle_t viewangle, angle;
+	UINT32 shiftup; // the fudge factor and flat scale both come from this
+
+	floatv3_t sup, svp, szp;
+	float zeroheight;
+} slopeveccache_t;
+
+static slopeveccache_t slopeveccache[SLOPEVECCACHESIZE];
+static UINT32 slopevecframe = 1;
+
 //
 // R_InitPlanes
 // Only at game startup.
@@ -331,6 +351,9 @@ void R_ClearPlanes(void)
 
 	numffloors = 0;
 
+	// Slopes and the view may have moved since the last view was drawn
+	slopevecframe++;
+
 	for (i = 0; i < MAXVISPLANES; i++)
 	{
 		for (*freehead = visplanes[i], visplanes[i] = NULL;
@@ -369,9 +392,44 @@ static visplane_t *new_visplane(unsigned hash)
 	}
 	check->next = visplanes[hash];
 	visplanes[hash] = check;
+	ps_numvisplanes.value.i++;
 	return check;
 }
 
+// Whether two planes draw the same surface, so their columns can be shared.
+static boolean R_SamePlane(const visplane_t *a, const visplane_t *b)
+{
+	return (a->height == b->height && a->picnum == b->picnum
+		&& a->lightlevel == b->lightlevel
+		&& a->xoffs == b->xoffs && a->yoffs == b->yoffs
+		&& a->extra_colormap == b->extra_colormap
+		&& a->viewx == b->viewx && a->viewy == b->viewy && a->viewz == b->viewz
+		&& a->viewangle == b->viewangle
+		&& a->plangle == b->plangle
+		&& a->polyobj == b->polyobj
+		&& a->slope == b->slope
+		&& a->ffloor == b->ffloor
+		&& a->noencore == b->noencore);
+}
+
+// Whether none of the columns from start to stop are in use yet.
+static boolean R_PlaneColumnsFree(const visplane_t *pl, INT32 start, INT32 stop)
+{
+	INT32 x;
+
+	if (start < pl->minx)
+		start = pl->minx;
+	if (stop > pl->maxx)
+		stop = pl->maxx;
+
+	// 0xff is not equal to -1 with shorts...
+	for (x = start; x <= stop; x++)
+		if (pl->top[x] != 0xffff || pl->bottom[x] != 0x0000)
+			return false;
+
+	return true;
+}
+
 //
 // R_FindPlane: Seek a visplane having the identical values:
 //              Same height, same flattexture, same lightlevel.
@@ -488,41 +546,10 @@ visplane_t *R_FindPlane(fixed_t height, INT32 picnum, INT32 lightlevel,
 //
 visplane_t *R_CheckPlane(visplane_t *pl, INT32 start, INT32 stop)
 {
-	INT32 intrl, intrh;
-	INT32 unionl, unionh;
-	INT32 x;
-
-	if (start < pl->minx)
+	if (R_PlaneColumnsFree(pl, start, stop)) /* Can use existing plane; extend range */
 	{
-		intrl = pl->minx;
-		unionl = start;
-	}
-	else
-	{
-		unionl = pl->minx;
-		intrl = start;
-	}
-
-	if (stop > pl->maxx)
-	{
-		intrh = pl->maxx;
-		unionh = stop;
-	}
-	else
-	{
-		unionh = pl->maxx;
-		intrh = stop;
-	}
-
-	// 0xff is not equal to -1 with shorts...
-	for (x = intrl; x <= intrh; x++)
-		if (pl->top[x] != 0xffff || pl->bottom[x] != 0x0000)
-			break;
-
-	if (x > intrh) /* Can use existing plane; extend range */
-	{
-		pl->minx = unionl;
-		pl->maxx = unionh;
+		pl->minx = min(pl->minx, start);
+		pl->maxx = max(pl->maxx, stop);
 	}
 	else /* Cannot use existing plane; create a new one */
 	{
@@ -534,6 +561,25 @@ visplane_t *R_CheckPlane(visplane_t *pl, INT32 start, INT32 stop)
 		else
 		{
 			unsigned hash = visplane_hash(pl->picnum, pl->lightlevel, pl->height);
+
+			// An earlier split of the same surface may still have these
+			// columns free. Tilted spans restart their perspective steps
+			// where a plane ends, so sloped planes are left as they were.
+			if (!pl->polyobj && !pl->slope)
+			{
+				for (new_pl = visplanes[hash]; new_pl; new_pl = new_pl->next)
+				{
+					if (new_pl != pl && R_SamePlane(new_pl, pl)
+						&& R_PlaneColumnsFree(new_pl, start, stop))
+					{
+						new_pl->minx = min(new_pl->minx, start);
+						new_pl->maxx = max(new_pl->maxx, stop);
+						ps_numplanemerges.value.i++;
+						return new_pl;
+					}
+				}
+			}
+
 			new_pl = new_visplane(hash);
 		}
 
@@ -782,6 +828,8 @@ d->z = (v1.x * v2.y) - (v1.y * v2.x)
 
 static void R_SetSlopePlaneVectors(visplane_t *pl, INT32 y, fixed_t xoff, fixed_t yoff, float fudge)
 {
+	slopeveccache_t *cache = &slopeveccache[((size_t)pl->slope->id + (UINT32)xoff*7 + (UINT32)yoff*13) % SLOPEVECCACHESIZE];
+
 	if (ds_su == NULL)
 		ds_su = Z_Malloc(sizeof(*ds_su) * vid.height, PU_STATIC, NULL);
 	if (ds_sv == NULL)
@@ -793,7 +841,36 @@ static void R_SetSlopePlaneVectors(visplane_t *pl, INT32 y, fixed_t xoff, fixed_
 	ds_svp = &ds_sv[y];
 	ds_szp = &ds_sz[y];
 
+	if (cache->frame == slopevecframe && cache->slope == pl->slope
+		&& cache->viewx == pl->viewx && cache->viewy == pl->viewy && cache->viewz == pl->viewz
+		&& cache->xoffset == xoff && cache->yoffset == yoff
+		&& cache->viewangle == pl->viewangle && cache->angle == pl->plangle
+		&& cache->shiftup == nflatshiftup)
+	{
+		*ds_sup = cache->sup;
+		*ds_svp = cache->svp;
+		*ds_szp = cache->szp;
+		zeroheight = cache->zeroheight;
+		return;
+	}
+
 	R_CalculateSlopeVectors(pl->slope, pl->viewx, pl->viewy, pl->viewz, FRACUNIT, FRACUNIT, xoff, yoff, pl->viewangle, pl->plangle, fudge);
+	ps_numslopevectors.value.i++;
+
+	cache->frame = slopevecframe;
+	cache->slope = pl->slope;
+	cache->viewx = pl->viewx;
+	cache->viewy = pl->viewy;
+	cache->viewz = pl->viewz;
+	cache->xoffset = xoff;
+	cache->yoffset = yoff;
+	cache->viewangle = pl->viewangle;
+	cache->angle = pl->plangle;
+	cache->shiftup = nflatshiftup;
+	cache->sup = *ds_sup;
+	cache->svp = *ds_svp;
+	cache->szp = *ds_szp;
+	cache->zeroheight = zeroheight;
 }
 
 
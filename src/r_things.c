@@ -1991,6 +1991,7 @@ void R_AddPrecipitationSprites(void)
 	}
 
 	R_GetRenderBlockMapDimensions(drawdist, &xl, &xh, &yl, &yh);
+	P_UpdatePrecipitationBlocks(xl, xh, yl, yh);
 
 	for (bx = xl; bx <= xh; bx++)
 	{
@@ -2015,78 +2016,71 @@ void R_AddPrecipitationSprites(void)
 //
 static vissprite_t vsprsortedhead;
 
+// Visible sprites in creation order, then in draw order
+static vissprite_t *vsprorder[MAXVISSPRITES];
+static vissprite_t *vsprmerge[MAXVISSPRITES];
+
+// Further away first, same scale by dispoffset, smallest first
+static inline boolean R_VisSpriteBefore(const vissprite_t *a, const vissprite_t *b)
+{
+	if (a->sortscale != b->sortscale)
+		return (a->sortscale < b->sortscale);
+	return (a->dispoffset < b->dispoffset);
+}
+
 void R_SortVisSprites(void)
 {
-	UINT32       i;
-	vissprite_t *ds, *dsprev, *dsnext, *dsfirst;
-	vissprite_t *best = NULL;
-	vissprite_t  unsorted;
-	fixed_t      bestscale;
-	INT32        bestdispoffset;
+	UINT32 i, count = 0;
+	UINT32 width;
+	vissprite_t **src = vsprorder, **dst = vsprmerge, **swap;
+
+	vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
 
 	if (!visspritecount)
 		return;
 
-	unsorted.next = unsorted.prev = &unsorted;
-
-	dsfirst = R_GetVisSprite(0);
-
-	// The first's prev and last's next will be set to
-	// nonsense, but are fixed in a moment
-	for (i = 0, dsnext = dsfirst, ds = NULL; i < visspritecount; i++)
+	// Drop the sprites that were determined to not be visible
+	for (i = 0; i < visspritecount; i++)
 	{
-		dsprev = ds;
-		ds = dsnext;
-		if (i < visspritecount - 1) dsnext = R_GetVisSprite(i + 1);
-
-		ds->next = dsnext;
-		ds->prev = dsprev;
+		vissprite_t *ds = R_GetVisSprite(i);
+		if (!(ds->cut & SC_NOTVISIBLE))
+			vsprorder[count++] = ds;
 	}
 
-	// Fix first and last. ds still points to the last one after the loop
-	dsfirst->prev = &unsorted;
-	unsorted.next = dsfirst;
-	if (ds)
-		ds->next = &unsorted;
-	unsorted.prev = ds;
-
-	// pull the vissprites out by scale
-	vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
-	for (i = 0; i < visspritecount; i++)
+	// Bottom-up merge sort. Ties keep their creation order,
+	// the same order the old selection sort picked them in.
+	for (width = 1; width < count; width *= 2)
 	{
-		bestscale = bestdispoffset = INT32_MAX;
-		for (ds = unsorted.next; ds != &unsorted; ds = ds->next)
+		for (i = 0; i < count; i += 2*width)
 		{
-			// Remove this sprite if it was determined to not be visible
-			if (ds->cut & SC_NOTVISIBLE)
-			{
-				ds->next->prev = ds->prev;
-				ds->prev->next = ds->next;
-				continue;
-			}
+			UINT32 left = i, mid = min(i + width, count), right = min(i + 2*width, count);
+			UINT32 a = left, b = mid, out = left;
 
-			if (ds->sortscale < bestscale)
+			while (a < mid && b < right)
 			{
-				bestscale = ds->sortscale;
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-			// order visprites of same scale by dispoffset, smallest first
-			else if (ds->sortscale == bestscale && ds->dispoffset < bestdispoffset)
-			{
-				bestdispoffset = ds->dispoffset;
-				best = ds;
+				if (R_VisSpriteBefore(src[b], src[a]))
+					dst[out++] = src[b++];
+				else
+					dst[out++] = src[a++];
 			}
+			while (a < mid)
+				dst[out++] = src[a++];
+			while (b < right)
+				dst[out++] = src[b++];
 		}
-		if (best)
-		{
-			best->next->prev = best->prev;
-			best->prev->next = best->next;
-			best->next = &vsprsortedhead;
-			best->prev = vsprsortedhead.prev;
-			vsprsortedhead.prev->next = best;
-			vsprsortedhead.prev = best;
-		}
+
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		vissprite_t *best = src[i];
+		best->next = &vsprsortedhead;
+		best->prev = vsprsortedhead.prev;
+		vsprsortedhead.prev->next = best;
+		vsprsortedhead.prev = best;
 	}
 }
 
@@ -1300,6 +1300,7 @@ const char *compat_special_music_slots[16] =
 
 static char      music_name[7]; // up to 6-character name
 static void      *music_data;
+static boolean   music_mapped; // music_data points into the file mapping
 static UINT16    music_flags;
 static boolean   music_looping;
 static consvar_t *music_refade_cv;
@@ -1891,7 +1892,11 @@ static boolean S_LoadMusic(const char *mname)
 	}
 
 	// load & register it
-	mdata = W_CacheLumpNum(mlumpnum, PU_MUSIC);
+	// uncompressed music can be played straight out of the mapped file
+	mdata = W_MapLumpNum(mlumpnum);
+	music_mapped = (mdata != NULL);
+	if (!music_mapped)
+		mdata = W_CacheLumpNum(mlumpnum, PU_MUSIC);
 
 	if (I_LoadSong(mdata, W_LumpLength(mlumpnum)))
 	{
@@ -1909,7 +1914,8 @@ static void S_UnloadMusic(void)
 	I_UnloadSong();
 
 #ifndef HAVE_SDL //SDL uses RWOPS
-	Z_ChangeTag(music_data, PU_CACHE);
+	if (!music_mapped)
+		Z_ChangeTag(music_data, PU_CACHE);
 #endif
 	music_data = NULL;
 
@@ -197,6 +197,12 @@ I_thread_is_stopped (void)
 	return ( ! SDL_AtomicGet(&i_threads_running) );
 }
 
+int
+I_cpu_count (void)
+{
+	return SDL_GetCPUCount();
+}
+
 void
 I_start_threads (void)
 {
@@ -28,6 +28,7 @@
 #include "z_zone.h"
 #include "m_misc.h"
 #include "m_random.h"
+#include "m_jobs.h"
 #include "doomstat.h"
 
 #ifdef HWRENDER
@@ -3290,6 +3291,31 @@ boolean *heatshifter = NULL;
 INT32 lastheight = 0;
 INT32 heatindex[MAXSPLITSCREENPLAYERS] = {0, 0, 0, 0};
 
+typedef struct
+{
+	const UINT8 *transme;
+	INT32 xoffset, yoffset;
+} motionblur_t;
+
+// Blends view rows [start, end) of screens[0] into the previous frame in
+// screens[4]. Every pixel only touches itself, so rows can run at once.
+static void V_MotionBlurRows(void *userdata, size_t start, size_t end)
+{
+	const motionblur_t *blur = userdata;
+	UINT8 *tmpscr = screens[4];
+	const UINT8 *srcscr = screens[0];
+	INT32 x, y;
+
+	for (y = blur->yoffset + (INT32)start; y < blur->yoffset + (INT32)end; y++)
+	{
+		for (x = blur->xoffset; x < blur->xoffset+viewwidth; x++)
+		{
+			tmpscr[y*vid.width + x]
+				=     colormaps[*(blur->transme + (srcscr   [(y*vid.width)+x ] <<8) + (tmpscr[(y*vid.width)+x]))];
+		}
+	}
+}
+
 //
 // V_DoPostProcessor
 //
@@ -3386,20 +3412,18 @@ void V_DoPostProcessor(INT32 view, postimg_t type, INT32 param)
 	else if (type == postimg_motion) // Motion Blur!
 	{
 		UINT8 *tmpscr = screens[4];
-		UINT8 *srcscr = screens[0];
-		INT32 x, y;
+		motionblur_t blur;
 
 		// TODO: Add a postimg_param so that we can pick the translucency level...
-		UINT8 *transme = transtables + ((param-1)<<FF_TRANSSHIFT);
+		blur.transme = transtables + ((param-1)<<FF_TRANSSHIFT);
+		blur.xoffset = xoffset;
+		blur.yoffset = yoffset;
+
+		if (cv_threadedpostprocess.value)
+			M_RunJobRange(V_MotionBlurRows, &blur, viewheight, 64);
+		else
+			V_MotionBlurRows(&blur, 0, viewheight);
 
-		for (y = yoffset; y < yoffset+viewheight; y++)
-		{
-			for (x = xoffset; x < xoffset+viewwidth; x++)
-			{
-				tmpscr[y*vid.width + x]
-					=     colormaps[*(transme     + (srcscr   [(y*vid.width)+x ] <<8) + (tmpscr[(y*vid.width)+x]))];
-			}
-		}
 		VID_BlitLinearScreen(tmpscr+vid.width*vid.bpp*yoffset+xoffset, screens[0]+vid.width*vid.bpp*yoffset+xoffset,
 				viewwidth*vid.bpp, viewheight, vid.width*vid.bpp, vid.width);
 	}
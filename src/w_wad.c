@@ -40,6 +40,19 @@
 #include "lzf.h"
 #endif
 
+// Map whole files into memory and read lumps straight out of them
+#if defined (_WIN32) || defined (UNIXCOMMON)
+#define MAPWADS
+#endif
+
+#ifdef MAPWADS
+#ifdef _WIN32
+#include <io.h> // _get_osfhandle
+#else
+#include <sys/mman.h>
+#endif
+#endif
+
 #include "doomdef.h"
 #include "doomstat.h"
 #include "doomtype.h"
@@ -63,6 +76,8 @@
 #include "lua_script.h"
 #include "st_stuff.h"
 #include "m_misc.h" // M_MapNumber
+#include "m_argv.h" // M_CheckParm
+#include "m_jobs.h" // W_PrefetchLumps
 #include "p_setup.h" // P_PartialAddFile mayb
 
 #ifdef HWRENDER
@@ -82,17 +97,32 @@ typedef struct
 	size_t len;
 } lumpchecklist_t;
 
-// Must be a power of two
-#define LUMPNUMCACHESIZE 64
-
-typedef struct lumpnum_cache_s
+// Hash index over the lump directories of every loaded file.
+// Each chain lists the newest file first and, inside one file, the lowest
+// lump number first, so the first match is the one a backwards scan of
+// wadfiles[] would have found.
+typedef struct
 {
-	char lumpname[32];
+	UINT32 next; // index + 1 of the next entry in the chain, 0 ends it
 	lumpnum_t lumpnum;
-} lumpnum_cache_t;
+} lumphashentry_t;
 
-static lumpnum_cache_t lumpnumcache[LUMPNUMCACHESIZE];
-static UINT16 lumpnumcacheindex = 0;
+typedef struct
+{
+	UINT32 (*hashlump)(const lumpinfo_t *lump_p);
+	UINT32 *buckets; // index + 1 of the first entry in the chain
+	lumphashentry_t *entries; // in insertion order
+	UINT32 numbuckets; // power of two
+	UINT32 numentries;
+} lumphash_t;
+
+static UINT32 W_HashLumpName(const lumpinfo_t *lump_p);
+static UINT32 W_HashLumpLongName(const lumpinfo_t *lump_p);
+static UINT32 W_HashLumpFullName(const lumpinfo_t *lump_p);
+
+static lumphash_t lumpnamehash = {W_HashLumpName, NULL, NULL, 0, 0};
+static lumphash_t lumplongnamehash = {W_HashLumpLongName, NULL, NULL, 0, 0};
+static lumphash_t lumpfullnamehash = {W_HashLumpFullName, NULL, NULL, 0, 0};
 
 //===========================================================================
 //                                                                    GLOBALS
@@ -100,6 +130,9 @@ static UINT16 lumpnumcacheindex = 0;
 UINT16 numwadfiles = 0; // number of active wadfiles
 wadfile_t *wadfiles[MAX_WADFILES]; // 0 to numwadfiles-1 are valid
 
+static void W_FreeLumpHash(lumphash_t *hash);
+static void W_UnmapFile(wadfile_t *wadfile);
+
 // W_Shutdown
 // Closes all of the WAD files before quitting
 // If not done on a Mac then open wad files
@@ -107,10 +140,16 @@ wadfile_t *wadfiles[MAX_WADFILES]; // 0 to numwadfiles-1 are valid
 // being ejected
 void W_Shutdown(void)
 {
+	W_FinishPrefetches();
+	W_FreeLumpHash(&lumpnamehash);
+	W_FreeLumpHash(&lumplongnamehash);
+	W_FreeLumpHash(&lumpfullnamehash);
+
 	while (numwadfiles--)
 	{
 		wadfile_t *wad = wadfiles[numwadfiles];
 
+		W_UnmapFile(wad);
 		if (wad->handle)
 			fclose(wad->handle);
 		Z_Free(wad->filename);
@@ -120,6 +159,7 @@ void W_Shutdown(void)
 			Z_Free(wad->lumpinfo[wad->numlumps].fullname);
 		}
 		Z_Free(wad->lumpinfo);
+		Z_Free(wad->prefetch);
 		Z_Free(wad);
 	}
 }
@@ -219,6 +259,61 @@ FILE *W_OpenWadFile(const char **filename, boolean useerrors)
 	return handle;
 }
 
+// W_MapFile
+// Maps the whole file read-only, so lumps can be read without a seek and a
+// read call each, and without copying compressed data before inflating it.
+// The pages are shared with every other process that has the same file open.
+// Leaves wadfile->mapping NULL if that isn't possible; reads then use the handle.
+static void W_MapFile(wadfile_t *wadfile)
+{
+	wadfile->mapping = NULL;
+
+#ifdef MAPWADS
+	if (!wadfile->filesize || M_CheckParm("-nommap"))
+		return;
+
+#ifdef _WIN32
+	{
+		HANDLE filemap = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(wadfile->handle)), NULL, PAGE_READONLY, 0, 0, NULL);
+		if (filemap == NULL)
+			return;
+		wadfile->mapping = MapViewOfFile(filemap, FILE_MAP_READ, 0, 0, wadfile->filesize);
+		CloseHandle(filemap); // the view keeps it alive
+	}
+#else
+	{
+		void *base = mmap(NULL, wadfile->filesize, PROT_READ, MAP_PRIVATE, fileno(wadfile->handle), 0);
+		if (base != MAP_FAILED)
+			wadfile->mapping = base;
+	}
+#endif
+#endif
+}
+
+static void W_UnmapFile(wadfile_t *wadfile)
+{
+	if (!wadfile->mapping)
+		return;
+
+#ifdef MAPWADS
+#ifdef _WIN32
+	UnmapViewOfFile(wadfile->mapping);
+#else
+	munmap(wadfile->mapping, wadfile->filesize);
+#endif
+#endif
+	wadfile->mapping = NULL;
+}
+
+// Returns where len bytes at pos are in the file mapping,
+// or NULL if the file isn't mapped or they run past its end.
+static inline UINT8 *W_MappedBytes(const wadfile_t *wadfile, size_t pos, size_t len)
+{
+	if (!wadfile->mapping || pos > wadfile->filesize || len > wadfile->filesize - pos)
+		return NULL;
+	return wadfile->mapping + pos;
+}
+
 // Look for all DEHACKED and Lua scripts inside a PK3 archive.
 static inline void W_LoadDehackedLumpsPK3(UINT16 wadnum)
 {
@@ -325,10 +420,160 @@ static inline INT32 W_MakeFileMD5(const char *filename, void *resblock)
 	return 1;
 }
 
-// Invalidates the cache of lump numbers. Call this whenever a wad is added.
-static void W_InvalidateLumpnumCache(void)
+//===========================================================================
+//                                                        LUMP NAME INDEXING
+//===========================================================================
+
+#define LUMPHASHSTART 0x811C9DC5 // FNV-1a
+#define LUMPHASHSTEP(h, c) (((h) ^ (UINT8)(c)) * 0x01000193)
+
+// Hashes all 8 bytes, the same ones W_CheckNumForNamePwad compares.
+static UINT32 W_HashName8(const char *name)
+{
+	UINT32 hash = LUMPHASHSTART;
+	size_t i;
+	for (i = 0; i < 8; i++)
+		hash = LUMPHASHSTEP(hash, name[i]);
+	return hash;
+}
+
+static UINT32 W_HashString(const char *name)
+{
+	UINT32 hash = LUMPHASHSTART;
+	for (; *name; name++)
+		hash = LUMPHASHSTEP(hash, *name);
+	return hash;
+}
+
+static UINT32 W_HashStringNoCase(const char *name)
+{
+	UINT32 hash = LUMPHASHSTART;
+	for (; *name; name++)
+		hash = LUMPHASHSTEP(hash, tolower(*name));
+	return hash;
+}
+
+static UINT32 W_HashLumpName(const lumpinfo_t *lump_p)
+{
+	return W_HashName8(lump_p->name);
+}
+
+static UINT32 W_HashLumpLongName(const lumpinfo_t *lump_p)
+{
+	return W_HashString(lump_p->longname);
+}
+
+static UINT32 W_HashLumpFullName(const lumpinfo_t *lump_p)
+{
+	return W_HashStringNoCase(lump_p->fullname);
+}
+
+static inline lumpinfo_t *W_LumpInfo(lumpnum_t lumpnum)
+{
+	return &wadfiles[WADFILENUM(lumpnum)]->lumpinfo[LUMPNUM(lumpnum)];
+}
+
+static void W_LinkLumpHashEntry(lumphash_t *hash, UINT32 entry)
+{
+	const UINT32 bucket = hash->hashlump(W_LumpInfo(hash->entries[entry].lumpnum)) & (hash->numbuckets - 1);
+	hash->entries[entry].next = hash->buckets[bucket];
+	hash->buckets[bucket] = entry + 1;
+}
+
+/** Adds every lump of a freshly loaded file to a lump index.
+  * Must be called in load order, so newer files end up first in the chains.
+  *
+  * \param hash The index to add to.
+  * \param wadnum The file that was just added to wadfiles[].
+  */
+static void W_IndexFileLumps(lumphash_t *hash, UINT16 wadnum)
+{
+	const UINT32 numentries = hash->numentries + wadfiles[wadnum]->numlumps;
+	UINT32 i;
+	UINT16 lump;
+
+	Z_Realloc(hash->entries, numentries * sizeof (*hash->entries), PU_STATIC, &hash->entries);
+
+	if (numentries > hash->numbuckets)
+	{
+		// Keep the chains short. Relinking in insertion order keeps their order.
+		while (numentries > hash->numbuckets)
+			hash->numbuckets = hash->numbuckets ? hash->numbuckets<<1 : 1024;
+
+		Z_Free(hash->buckets);
+		Z_Calloc(hash->numbuckets * sizeof (*hash->buckets), PU_STATIC, &hash->buckets);
+
+		for (i = 0; i < hash->numentries; i++)
+			W_LinkLumpHashEntry(hash, i);
+	}
+
+	// Backwards, so the first lump of the file ends up first
+	for (lump = wadfiles[wadnum]->numlumps; lump--;)
+	{
+		hash->entries[hash->numentries].lumpnum = (wadnum<<16) + lump;
+		W_LinkLumpHashEntry(hash, hash->numentries++);
+	}
+}
+
+static void W_FreeLumpHash(lumphash_t *hash)
+{
+	Z_Free(hash->buckets);
+	Z_Free(hash->entries);
+	hash->buckets = NULL;
+	hash->entries = NULL;
+	hash->numbuckets = hash->numentries = 0;
+}
+
+// Index the lumps of a file. Call this whenever a wad is added.
+static void W_IndexFile(UINT16 wadnum)
+{
+	W_IndexFileLumps(&lumpnamehash, wadnum);
+	W_IndexFileLumps(&lumplongnamehash, wadnum);
+	W_IndexFileLumps(&lumpfullnamehash, wadnum);
+}
+
+/** Finds the newest lump with exactly these 8 name bytes.
+  *
+  * \param name Zero padded 8 character lump name.
+  * \return The lump number, or LUMPERROR if not found.
+  */
+static lumpnum_t W_FindIndexedName(const char *name)
+{
+	UINT32 i;
+
+	if (!lumpnamehash.numbuckets)
+		return LUMPERROR;
+
+	for (i = lumpnamehash.buckets[W_HashName8(name) & (lumpnamehash.numbuckets - 1)]; i; i = lumpnamehash.entries[i - 1].next)
+	{
+		const lumpnum_t lumpnum = lumpnamehash.entries[i - 1].lumpnum;
+		if (memcmp(W_LumpInfo(lumpnum)->name, name, 8) == 0)
+			return lumpnum;
+	}
+
+	return LUMPERROR;
+}
+
+/** Finds the newest lump with this full path inside a PK3.
+  *
+  * \param name Path from the root of the PK3, not case sensitive.
+  * \return The lump number, or LUMPERROR if not found.
+  */
+static lumpnum_t W_FindIndexedFullName(const char *name)
 {
-	memset(lumpnumcache, 0, sizeof (lumpnumcache));
+	UINT32 i;
+
+	if (!lumpfullnamehash.numbuckets)
+		return LUMPERROR;
+
+	for (i = lumpfullnamehash.buckets[W_HashStringNoCase(name) & (lumpfullnamehash.numbuckets - 1)]; i; i = lumpfullnamehash.entries[i - 1].next)
+	{
+		const lumpnum_t lumpnum = lumpfullnamehash.entries[i - 1].lumpnum;
+		if (wadfiles[WADFILENUM(lumpnum)]->type == RET_PK3 && !stricmp(W_LumpInfo(lumpnum)->fullname, name))
+			return lumpnum;
+	}
+
+	return LUMPERROR;
 }
 
 /** Detect a file type.
@@ -808,6 +1053,7 @@ UINT16 W_InitFile(const char *filename, boolean local)
 	fseek(handle, 0, SEEK_END);
 	wadfile->filesize = (unsigned)ftell(handle);
 	wadfile->type = type;
+	W_MapFile(wadfile);
 
 	// already generated, just copy it over
 	M_Memcpy(&wadfile->md5sum, &md5sum, 16);
@@ -829,6 +1075,9 @@ UINT16 W_InitFile(const char *filename, boolean local)
 	wadfiles[numwadfiles] = wadfile;
 	numwadfiles++; // must come BEFORE W_LoadDehackedLumps, so any addfile called by COM_BufInsertText called by Lua doesn't overwrite what we just loaded
 
+	// and so must this, the lumps have to be findable by then
+	W_IndexFile(numwadfiles - 1);
+
 #ifdef HWRENDER
 	// Read shaders from file
 	if (rendermode == render_opengl && (vid.glstate == VID_GL_LIBRARY_LOADED))
@@ -859,7 +1108,6 @@ UINT16 W_InitFile(const char *filename, boolean local)
 		G_LoadGameData();
 	DEH_UpdateMaxFreeslots();
 
-	W_InvalidateLumpnumCache();
 	return wadfile->numlumps;
 }
 
@@ -1091,43 +1339,16 @@ UINT16 W_CheckNumForFullNamePK3(const char *name, UINT16 wad, UINT16 startlump)
 //
 lumpnum_t W_CheckNumForName(const char *name)
 {
-	INT32 i;
-	lumpnum_t check = INT16_MAX;
+	char uname[9];
 
 	if (!*name) // some doofus gave us an empty string?
 		return LUMPERROR;
 
-	// Check the lumpnumcache first. Loop backwards so that we check
-	// most recent entries first
-	for (i = lumpnumcacheindex + LUMPNUMCACHESIZE; i > lumpnumcacheindex; i--)
-	{
-		if (!lumpnumcache[i & (LUMPNUMCACHESIZE - 1)].lumpname[8]
-			&& strncmp(lumpnumcache[i & (LUMPNUMCACHESIZE - 1)].lumpname, name, 8) == 0)
-		{
-			lumpnumcacheindex = i & (LUMPNUMCACHESIZE - 1);
-			return lumpnumcache[lumpnumcacheindex].lumpnum;
-		}
-	}
-
-	// scan wad files backwards so patch lump files take precedence
-	for (i = numwadfiles - 1; i >= 0; i--)
-	{
-		check = W_CheckNumForNamePwad(name,(UINT16)i,0);
-		if (check != INT16_MAX)
-			break; //found it
-	}
-
-	if (check == INT16_MAX) return LUMPERROR;
-	else
-	{
-		// Update the cache.
-		lumpnumcacheindex = (lumpnumcacheindex + 1) & (LUMPNUMCACHESIZE - 1);
-		memset(lumpnumcache[lumpnumcacheindex].lumpname, '\0', 32);
-		strncpy(lumpnumcache[lumpnumcacheindex].lumpname, name, 8);
-		lumpnumcache[lumpnumcacheindex].lumpnum = (i<<16)+check;
+	memset(uname, 0, sizeof uname);
+	strncpy(uname, name, sizeof(uname)-1);
+	strupr(uname);
 
-		return lumpnumcache[lumpnumcacheindex].lumpnum;
-	}
+	return W_FindIndexedName(uname);
 }
 
 //
@@ -1138,83 +1359,72 @@ lumpnum_t W_CheckNumForName(const char *name)
 //
 lumpnum_t W_CheckNumForLongName(const char *name)
 {
-	INT32 i;
-	lumpnum_t check = INT16_MAX;
+	char uname[256 + 1];
+	UINT32 i;
 
 	if (!*name) // some doofus gave us an empty string?
 		return LUMPERROR;
 
-	// Check the lumpnumcache first. Loop backwards so that we check
-	// most recent entries first
-	for (i = lumpnumcacheindex + LUMPNUMCACHESIZE; i > lumpnumcacheindex; i--)
-	{
-		if (strcmp(lumpnumcache[i & (LUMPNUMCACHESIZE - 1)].lumpname, name) == 0)
-		{
-			lumpnumcacheindex = i & (LUMPNUMCACHESIZE - 1);
-			return lumpnumcache[lumpnumcacheindex].lumpnum;
-		}
-	}
+	if (!lumplongnamehash.numbuckets)
+		return LUMPERROR;
 
-	if (check == INT16_MAX)
-	{
-		// scan wad files backwards so patch lump files take precedence
-		for (i = numwadfiles - 1; i >= 0; i--)
-		{
-			check = W_CheckNumForLongNamePwad(name,(UINT16)i,0);
-			if (check != INT16_MAX)
-				break; //found it
-		}
-	}
+	strlcpy(uname, name, sizeof uname);
+	strupr(uname);
 
-	if (check == INT16_MAX) return LUMPERROR;
-	else
+	for (i = lumplongnamehash.buckets[W_HashString(uname) & (lumplongnamehash.numbuckets - 1)]; i; i = lumplongnamehash.entries[i - 1].next)
 	{
-		if (strlen(name) < 32)
-		{
-			// Update the cache.
-			lumpnumcacheindex = (lumpnumcacheindex + 1) & (LUMPNUMCACHESIZE - 1);
-			memset(lumpnumcache[lumpnumcacheindex].lumpname, '\0', 32);
-			strlcpy(lumpnumcache[lumpnumcacheindex].lumpname, name, 32);
-			lumpnumcache[lumpnumcacheindex].lumpnum = (i << 16) + check;
-		}
-
-		return (i << 16) + check;
+		const lumpnum_t lumpnum = lumplongnamehash.entries[i - 1].lumpnum;
+		if (!strcmp(W_LumpInfo(lumpnum)->longname, uname))
+			return lumpnum;
 	}
+
+	return LUMPERROR;
 }
 
 // Look for valid map data through all added files in descendant order.
 // Get a map marker for WADs, and a standalone WAD file lump inside PK3s.
-// TODO: Make it search through cache first, maybe...?
+// Both come from the lump indexes: the newest file with either wins, and
+// inside one file the first lump.
 lumpnum_t W_CheckNumForMap(const char *name)
 {
-	UINT16 lumpNum, end;
+	char uname[8];
+	char path[5 + 256 + 4 + 1];
+	const char *const paths[] = {"maps/%s.wad", "maps/%s"};
+	lumpnum_t best = LUMPERROR;
 	UINT32 i;
-	for (i = numwadfiles - 1; i < numwadfiles; i--)
+
+	if (!*name || !lumpnamehash.numbuckets)
+		return LUMPERROR;
+
+	// A map marker in a WAD
+	memset(uname, 0, sizeof uname);
+	strncpy(uname, name, sizeof uname);
+	for (i = lumpnamehash.buckets[W_HashName8(uname) & (lumpnamehash.numbuckets - 1)]; i; i = lumpnamehash.entries[i - 1].next)
 	{
-		if (wadfiles[i]->type == RET_WAD)
+		const lumpnum_t lumpnum = lumpnamehash.entries[i - 1].lumpnum;
+		if (wadfiles[WADFILENUM(lumpnum)]->type == RET_WAD && memcmp(W_LumpInfo(lumpnum)->name, uname, 8) == 0)
 		{
-			for (lumpNum = 0; lumpNum < wadfiles[i]->numlumps; lumpNum++)
-				if (!strncmp(name, (wadfiles[i]->lumpinfo + lumpNum)->name, 8))
-					return (i<<16) + lumpNum;
-		}
-		else if (wadfiles[i]->type == RET_PK3)
-		{
-			lumpNum = W_CheckNumForFolderStartPK3("maps/", i, 0);
-			if (lumpNum != INT16_MAX)
-				end = W_CheckNumForFolderEndPK3("maps/", i, lumpNum);
-			else
-				continue;
-			// Now look for the specified map.
-			for (; lumpNum < end; lumpNum++)
-				if (!strnicmp(name, (wadfiles[i]->lumpinfo + lumpNum)->name, 8))
-				{
-					const char *extension = strrchr(wadfiles[i]->lumpinfo[lumpNum].fullname, '.');
-					if (!(extension && stricmp(extension, ".wad")))
-						return (i<<16) + lumpNum;
-				}
+			best = lumpnum;
+			break;
 		}
 	}
-	return LUMPERROR;
+
+	// A map WAD in a PK3's maps folder, with or without its extension
+	for (i = 0; i < sizeof paths / sizeof *paths; i++)
+	{
+		lumpnum_t lumpnum;
+
+		snprintf(path, sizeof path, paths[i], name);
+		lumpnum = W_FindIndexedFullName(path);
+		if (lumpnum == LUMPERROR)
+			continue;
+
+		if (best == LUMPERROR || WADFILENUM(lumpnum) > WADFILENUM(best)
+			|| (WADFILENUM(lumpnum) == WADFILENUM(best) && LUMPNUM(lumpnum) < LUMPNUM(best)))
+			best = lumpnum;
+	}
+
+	return best;
 }
 
 //
@@ -1286,15 +1496,15 @@ lumpnum_t W_CheckNumForNameInBlock(const char *name, const char *blockstart, con
 #include "fastcmp.h"
 UINT8 W_LumpExists(const char *name)
 {
-	INT32 i,j;
-	for (i = numwadfiles - 1; i >= 0; i--)
-	{
-		lumpinfo_t *lump_p = wadfiles[i]->lumpinfo;
-		for (j = 0; j < wadfiles[i]->numlumps; ++j, ++lump_p)
-			if (fastcmp(lump_p->name,name))
-				return true;
-	}
-	return false;
+	char padded[8];
+
+	// lump names are never longer than this
+	if (strlen(name) > sizeof padded)
+		return false;
+
+	memset(padded, 0, sizeof padded);
+	memcpy(padded, name, strlen(name));
+	return (W_FindIndexedName(padded) != LUMPERROR);
 }
 
 UINT8 W_CheckMultipleLumps(const char* lump, ...) 
@@ -1428,6 +1638,7 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 	size_t lumpsize;
 	lumpinfo_t *l;
 	FILE *handle;
+	UINT8 *mapped;
 
 	if (!TestValidLump(wad,lump))
 		return 0;
@@ -1442,37 +1653,50 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 		size = lumpsize - offset;
 
 	// Let's get the raw lump data.
-	// We setup the desired file handle to read the lump data.
+	// Straight from the file mapping if we have one,
+	// otherwise we setup the desired file handle to read the lump data.
 	l = wadfiles[wad]->lumpinfo + lump;
 	handle = wadfiles[wad]->handle;
-	fseek(handle, (long)(l->position + offset), SEEK_SET);
+	mapped = W_MappedBytes(wadfiles[wad], l->position, (l->compression == CM_NOCOMPRESSION) ? l->size : l->disksize);
+	if (!mapped)
+		fseek(handle, (long)(l->position + offset), SEEK_SET);
 
 	// But let's not copy it yet. We support different compression formats on lumps, so we need to take that into account.
 	switch(wadfiles[wad]->lumpinfo[lump].compression)
 	{
 	case CM_NOCOMPRESSION:		// If it's uncompressed, we directly write the data into our destination, and return the bytes read.
-#ifdef NO_PNG_LUMPS
 		{
-			size_t bytesread = fread(dest, 1, size, handle);
+			size_t bytesread;
+			if (mapped)
+			{
+				M_Memcpy(dest, mapped + offset, size);
+				bytesread = size;
+			}
+			else
+				bytesread = fread(dest, 1, size, handle);
+#ifdef NO_PNG_LUMPS
 			ErrorIfPNG(dest, bytesread, wadfiles[wad]->filename, l->fullname);
+#endif
 			return bytesread;
 		}
-#else
-		return fread(dest, 1, size, handle);
-#endif
 	case CM_LZF:		// Is it LZF compressed? Used by ZWADs.
 		{
 #ifdef ZWAD
-			char *rawData; // The lump's raw data.
+			char *rawData = NULL; // The lump's raw data, if it had to be read.
 			char *decData; // Lump's decompressed real data.
 			size_t retval; // Helper var, lzf_decompress returns 0 when an error occurs.
 
-			rawData = Z_Malloc(l->disksize, PU_STATIC, NULL);
 			decData = Z_Malloc(l->size, PU_STATIC, NULL);
 
-			if (fread(rawData, 1, l->disksize, handle) < l->disksize)
-				I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
-			retval = lzf_decompress(rawData, l->disksize, decData, l->size);
+			if (mapped)
+				retval = lzf_decompress(mapped, l->disksize, decData, l->size);
+			else
+			{
+				rawData = Z_Malloc(l->disksize, PU_STATIC, NULL);
+				if (fread(rawData, 1, l->disksize, handle) < l->disksize)
+					I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+				retval = lzf_decompress(rawData, l->disksize, decData, l->size);
+			}
 #ifndef AVOID_ERRNO
 			if (retval == 0) // If this was returned, check if errno was set
 			{
@@ -1507,7 +1731,7 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 #ifdef HAVE_ZLIB
 	case CM_DEFLATE: // Is it compressed via DEFLATE? Very common in ZIPs/PK3s, also what most doom-related editors support.
 		{
-			UINT8 *rawData; // The lump's raw data.
+			UINT8 *rawData = NULL; // The lump's raw data, if it had to be read.
 			UINT8 *decData; // Lump's decompressed real data.
 
 			int zErr; // Helper var.
@@ -1515,11 +1739,14 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 			unsigned long rawSize = l->disksize;
 			unsigned long decSize = l->size;
 
-			rawData = Z_Malloc(rawSize, PU_STATIC, NULL);
 			decData = Z_Malloc(decSize, PU_STATIC, NULL);
 
-			if (fread(rawData, 1, rawSize, handle) < rawSize)
-				I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+			if (!mapped)
+			{
+				rawData = Z_Malloc(rawSize, PU_STATIC, NULL);
+				if (fread(rawData, 1, rawSize, handle) < rawSize)
+					I_Error("wad %d, lump %d: cannot read compressed data", wad, lump);
+			}
 
 			strm.zalloc = Z_NULL;
 			strm.zfree = Z_NULL;
@@ -1528,7 +1755,7 @@ size_t W_ReadLumpHeaderPwad(UINT16 wad, UINT16 lump, void *dest, size_t size, si
 			strm.total_in = strm.avail_in = rawSize;
 			strm.total_out = strm.avail_out = decSize;
 
-			strm.next_in = rawData;
+			strm.next_in = mapped ? mapped : rawData;
 			strm.next_out = decData;
 
 			zErr = inflateInit2(&strm, -15);
@@ -1590,6 +1817,169 @@ void W_ReadLumpPwad(UINT16 wad, UINT16 lump, void *dest)
 	W_ReadLumpHeaderPwad(wad, lump, dest, 0, 0);
 }
 
+// ==========================================================================
+// Background lump decompression
+// ==========================================================================
+
+typedef struct lumpprefetch_s
+{
+	UINT16 wad, lump;
+	void *data; // PU_CACHE block the lump is decompressed into, until it's claimed
+	boolean ok; // set by the job
+	jobgroup_t job;
+} lumpprefetch_t;
+
+static lumpprefetch_t **prefetches; // every prefetch since the last W_FinishPrefetches
+static size_t numprefetches, maxprefetches;
+
+// Decompresses a whole lump from src into dest.
+// Runs on worker threads, so no zone memory, no console, no I_Error.
+static boolean W_DecompressLump(const lumpinfo_t *l, UINT8 *src, void *dest)
+{
+	switch (l->compression)
+	{
+#ifdef ZWAD
+	case CM_LZF:
+		return (lzf_decompress(src, l->disksize, dest, l->size) == l->size);
+#endif
+#ifdef HAVE_ZLIB
+	case CM_DEFLATE:
+		{
+			z_stream strm;
+			int zErr;
+
+			strm.zalloc = Z_NULL;
+			strm.zfree = Z_NULL;
+			strm.opaque = Z_NULL;
+
+			strm.total_in = strm.avail_in = l->disksize;
+			strm.total_out = strm.avail_out = l->size;
+
+			strm.next_in = src;
+			strm.next_out = dest;
+
+			if (inflateInit2(&strm, -15) != Z_OK)
+				return false;
+			zErr = inflate(&strm, Z_FINISH);
+			(void)inflateEnd(&strm);
+			return (zErr == Z_STREAM_END);
+		}
+#endif
+	default:
+		return false;
+	}
+}
+
+static void W_PrefetchJob(void *userdata)
+{
+	lumpprefetch_t *prefetch = userdata;
+	wadfile_t *wadfile = wadfiles[prefetch->wad];
+	const lumpinfo_t *l = &wadfile->lumpinfo[prefetch->lump];
+
+	prefetch->ok = W_DecompressLump(l, wadfile->mapping + l->position, prefetch->data);
+}
+
+/** Starts decompressing lumps on the job threads, so that caching them
+  * later doesn't have to. Only compressed lumps of mapped files are worth
+  * it; everything else is skipped, as are lumps that are already cached.
+  *
+  * W_CacheLumpNum waits for a lump's job if it's still running.
+  * Call W_FinishPrefetches once the lumps are no longer needed soon.
+  *
+  * \param lumpnums Lumps to decompress, LUMPERROR entries are ignored.
+  * \param count Number of entries in lumpnums.
+  * \sa W_FinishPrefetches
+  */
+void W_PrefetchLumps(const lumpnum_t *lumpnums, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		UINT16 wad = WADFILENUM(lumpnums[i]), lump = LUMPNUM(lumpnums[i]);
+		wadfile_t *wadfile;
+		lumpinfo_t *l;
+		lumpprefetch_t *prefetch;
+
+		if (lumpnums[i] == LUMPERROR || !TestValidLump(wad, lump))
+			continue;
+
+		wadfile = wadfiles[wad];
+		l = &wadfile->lumpinfo[lump];
+		if (wadfile->lumpcache[lump] || !l->size
+			|| l->compression == CM_NOCOMPRESSION || l->compression == CM_UNSUPPORTED
+			|| !W_MappedBytes(wadfile, l->position, l->disksize))
+			continue;
+
+		if (!wadfile->prefetch)
+			wadfile->prefetch = Z_Calloc(wadfile->numlumps * sizeof (*wadfile->prefetch), PU_STATIC, NULL);
+		else if (wadfile->prefetch[lump])
+			continue;
+
+		if (numprefetches == maxprefetches)
+		{
+			maxprefetches = maxprefetches ? maxprefetches * 2 : 256;
+			prefetches = Z_Realloc(prefetches, maxprefetches * sizeof (*prefetches), PU_STATIC, NULL);
+		}
+
+		prefetch = Z_Calloc(sizeof (*prefetch), PU_STATIC, NULL);
+		prefetch->wad = wad;
+		prefetch->lump = lump;
+		prefetch->data = Z_Malloc(l->size, PU_CACHE, NULL);
+		wadfile->prefetch[lump] = prefetches[numprefetches++] = prefetch;
+
+		M_AddJob(&prefetch->job, W_PrefetchJob, prefetch);
+	}
+}
+
+// Waits for the lump's prefetch, if any, and puts its result in the cache.
+// Returns false if the lump still has to be read the usual way.
+static boolean W_ClaimPrefetch(UINT16 wad, UINT16 lump, INT32 tag)
+{
+	wadfile_t *wadfile = wadfiles[wad];
+	lumpprefetch_t *prefetch;
+
+	if (!wadfile->prefetch || !(prefetch = wadfile->prefetch[lump]))
+		return false;
+
+	M_WaitJobs(&prefetch->job);
+	wadfile->prefetch[lump] = NULL;
+
+	if (!prefetch->ok || wadfile->lumpcache[lump])
+	{
+		// Bad data gets the usual error messages from W_ReadLumpHeaderPwad.
+		Z_Free(prefetch->data);
+		prefetch->data = NULL;
+		return false;
+	}
+
+#ifdef NO_PNG_LUMPS
+	ErrorIfPNG(prefetch->data, wadfile->lumpinfo[lump].size, wadfile->filename, wadfile->lumpinfo[lump].fullname);
+#endif
+	Z_SetUser(prefetch->data, &wadfile->lumpcache[lump]);
+	Z_ChangeTag(prefetch->data, tag);
+	prefetch->data = NULL;
+	return true;
+}
+
+/** Waits for all prefetches to finish and caches the lumps nobody asked
+  * for yet as PU_CACHE.
+  *
+  * \sa W_PrefetchLumps
+  */
+void W_FinishPrefetches(void)
+{
+	size_t i;
+
+	for (i = 0; i < numprefetches; i++)
+	{
+		if (prefetches[i]->data)
+			W_ClaimPrefetch(prefetches[i]->wad, prefetches[i]->lump, PU_CACHE);
+		Z_Free(prefetches[i]);
+	}
+	numprefetches = 0;
+}
+
 // ==========================================================================
 // W_CacheLumpNum
 // ==========================================================================
@@ -1603,8 +1993,12 @@ void *W_CacheLumpNumPwad(UINT16 wad, UINT16 lump, INT32 tag)
 	lumpcache = wadfiles[wad]->lumpcache;
 	if (!lumpcache[lump])
 	{
-		void *ptr = Z_Malloc(W_LumpLengthPwad(wad, lump), tag, &lumpcache[lump]);
-		W_ReadLumpHeaderPwad(wad, lump, ptr, 0, 0);  // read the lump in full
+		// Maybe it's already been decompressed in the background.
+		if (!W_ClaimPrefetch(wad, lump, tag))
+		{
+			void *ptr = Z_Malloc(W_LumpLengthPwad(wad, lump), tag, &lumpcache[lump]);
+			W_ReadLumpHeaderPwad(wad, lump, ptr, 0, 0);  // read the lump in full
+		}
 	}
 	else
 		Z_ChangeTag(lumpcache[lump], tag);
@@ -1618,6 +2012,43 @@ void *W_CacheLumpNum(lumpnum_t lumpnum, INT32 tag)
 	return W_CacheLumpNumPwad(WADFILENUM(lumpnum),LUMPNUM(lumpnum),tag);
 }
 
+/** Gets an uncompressed lump's data straight from the file mapping,
+  * without reading or copying it.
+  *
+  * The memory is read-only (writing to it crashes), is not zone memory (never Z_Free or Z_ChangeTag it),
+  * stays valid until the game exits and has no particular alignment.
+  *
+  * \param wad Wad number to look in.
+  * \param lump Lump number to look at.
+  * \return Pointer to the lump's data, or NULL if it has to be read or
+  *         cached the usual way instead.
+  * \sa W_CacheLumpNumPwad
+  */
+void *W_MapLumpNumPwad(UINT16 wad, UINT16 lump)
+{
+	lumpinfo_t *l;
+	UINT8 *mapped;
+
+	if (!TestValidLump(wad,lump))
+		return NULL;
+
+	l = wadfiles[wad]->lumpinfo + lump;
+	if (l->compression != CM_NOCOMPRESSION || !l->size)
+		return NULL;
+
+	mapped = W_MappedBytes(wadfiles[wad], l->position, l->size);
+#ifdef NO_PNG_LUMPS
+	if (mapped)
+		ErrorIfPNG(mapped, l->size, wadfiles[wad]->filename, l->fullname);
+#endif
+	return mapped;
+}
+
+void *W_MapLumpNum(lumpnum_t lumpnum)
+{
+	return W_MapLumpNumPwad(WADFILENUM(lumpnum),LUMPNUM(lumpnum));
+}
+
 //
 // W_CacheLumpNumForce
 //
@@ -2126,6 +2557,15 @@ int W_VerifyNMUSlumps(const char *filename)
  * \return Virtual resource
  *
  */
+// Map data is read with INT16 casts, so only use mappings aligned for those
+static UINT8 *vres_MapLump(lumpnum_t lumpnum, size_t align)
+{
+	UINT8 *mapped = W_MapLumpNum(lumpnum);
+	if (!mapped || (uintptr_t)mapped % align)
+		return NULL;
+	return mapped;
+}
+
 virtres_t* vres_GetMap(lumpnum_t lumpnum)
 {
 	UINT32 i;
@@ -2145,7 +2585,9 @@ virtres_t* vres_GetMap(lumpnum_t lumpnum)
 		size_t *vsizecache;
 
 		// Remember that we're assuming that the WAD will have a specific set of lumps in a specific order.
-		UINT8 *wadData = (UINT8*)(W_CacheLumpNum(lumpnum, PU_LEVEL));
+		// If the WAD is stored uncompressed, its lumps can be used right where they are.
+		UINT8 *mapData = vres_MapLump(lumpnum, sizeof (UINT32));
+		UINT8 *wadData = mapData ? mapData : (UINT8*)(W_CacheLumpNum(lumpnum, PU_LEVEL));
 		filelump_t *fileinfo = (filelump_t *)(wadData + LONG(((wadinfo_t *)wadData)->infotableofs));
 
 		i = LONG(((wadinfo_t *)wadData)->numlumps);
@@ -2180,15 +2622,22 @@ virtres_t* vres_GetMap(lumpnum_t lumpnum)
 			// Play it safe with the name in this case.
 			memcpy(vlumps[i].name, name, 8);
 			vlumps[i].name[8] = '\0';
-			vlumps[i].data = (UINT8*)(
-				Z_Malloc(vlumps[i].size, PU_LEVEL, NULL) // This is memory inefficient, sorry about that.
-			);
-			memcpy(vlumps[i].data, wadData + LONG((fileinfo + realentry)->filepos), vlumps[i].size);
+			vlumps[i].mapped = (mapData && LONG((fileinfo + realentry)->filepos) % sizeof (INT16) == 0);
+			if (vlumps[i].mapped)
+				vlumps[i].data = mapData + LONG((fileinfo + realentry)->filepos);
+			else
+			{
+				vlumps[i].data = (UINT8*)(
+					Z_Malloc(vlumps[i].size, PU_LEVEL, NULL) // This is memory inefficient, sorry about that.
+				);
+				memcpy(vlumps[i].data, wadData + LONG((fileinfo + realentry)->filepos), vlumps[i].size);
+			}
 			i++;
 		}
 
 		Z_Free(vsizecache);
-		Z_Free(wadData);
+		if (!mapData)
+			Z_Free(wadData);
 	}
 	else
 	{
@@ -2203,6 +2652,15 @@ virtres_t* vres_GetMap(lumpnum_t lumpnum)
 		}
 		numlumps++;
 
+		// PK3 map lumps are usually deflated, so decompress them all at once.
+		{
+			lumpnum_t *prefetch = Z_Malloc(sizeof(lumpnum_t)*numlumps, PU_STATIC, NULL);
+			for (i = 0; i < numlumps; i++)
+				prefetch[i] = lumpnum + i;
+			W_PrefetchLumps(prefetch, numlumps);
+			Z_Free(prefetch);
+		}
+
 		vlumps = (virtlump_t*)(Z_Malloc(sizeof(virtlump_t)*numlumps, PU_LEVEL, NULL));
 		for (i = 0; i < numlumps; i++, lumpnum++)
 		{
@@ -2218,8 +2676,12 @@ virtres_t* vres_GetMap(lumpnum_t lumpnum)
 			vlumps[i].size = W_LumpLength(lumpnum);
 			memcpy(vlumps[i].name, name, 8);
 			vlumps[i].name[8] = '\0';
-			vlumps[i].data = (UINT8*)(W_CacheLumpNum(lumpnum, PU_LEVEL));
+			vlumps[i].data = vres_MapLump(lumpnum, sizeof (INT16));
+			vlumps[i].mapped = (vlumps[i].data != NULL);
+			if (!vlumps[i].mapped)
+				vlumps[i].data = (UINT8*)(W_CacheLumpNum(lumpnum, PU_LEVEL));
 		}
+		W_FinishPrefetches();
 	}
 	vres = (virtres_t*)(Z_Malloc(sizeof(virtres_t), PU_LEVEL, NULL));
 	vres->vlumps = vlumps;
@@ -2242,7 +2704,7 @@ void vres_Free(virtres_t* vres)
 
 	while (vres->numlumps--)
 	{
-		if (vres->vlumps[vres->numlumps].data)
+		if (vres->vlumps[vres->numlumps].data && !vres->vlumps[vres->numlumps].mapped)
 		{
 			Z_Free(vres->vlumps[vres->numlumps].data);
 		}
@@ -83,6 +83,7 @@ typedef struct {
 	char name[9];
 	UINT8* data;
 	size_t size;
+	boolean mapped; // data points into the file mapping, don't free it
 } virtlump_t;
 
 typedef struct {
@@ -127,11 +128,13 @@ typedef struct wadfile_s
 	restype_t type;
 	lumpinfo_t *lumpinfo;
 	lumpcache_t *lumpcache;
+	struct lumpprefetch_s **prefetch; // lumps being decompressed in the background, NULL until one is
 #ifdef HWRENDER
 	aatree_t *hwrcache; // patches are cached in renderer's native format
 #endif
 	UINT16 numlumps; // this wad's number of resources
 	FILE *handle;
+	UINT8 *mapping; // read-only view of the whole file, NULL if not mapped
 	UINT32 filesize; // for network
 	UINT8 md5sum[16];
 	boolean important;
@@ -207,6 +210,14 @@ void *W_CacheLumpNumPwad(UINT16 wad, UINT16 lump, INT32 tag);
 void *W_CacheLumpNum(lumpnum_t lump, INT32 tag);
 void *W_CacheLumpNumForce(lumpnum_t lumpnum, INT32 tag);
 
+// Decompress lumps on the job threads ahead of caching them
+void W_PrefetchLumps(const lumpnum_t *lumpnums, size_t count);
+void W_FinishPrefetches(void);
+
+// Uncompressed lumps straight from the file mapping, NULL if unavailable. Read-only, never free these.
+void *W_MapLumpNumPwad(UINT16 wad, UINT16 lump);
+void *W_MapLumpNum(lumpnum_t lumpnum);
+
 boolean W_IsLumpCached(lumpnum_t lump, void *ptr);
 
 void *W_CacheLumpName(const char *name, INT32 tag);
@@ -24,6 +24,12 @@
 ///        caught with this direct-malloc version. We also suspected that SRB2's
 ///        allocator was fragmenting badly. Finally, this version is a bit
 ///        simpler (about half the lines of code).
+///
+///        Small blocks with a level tag (PU_LEVEL <= tag < PU_PURGELEVEL) are
+///        not malloc'd individually, they are carved out of per-tag,
+///        per-size-class slabs instead. Mobjs, precipitation and most thinkers
+///        live there, so spawning and removing them is a freelist push/pop,
+///        and Z_FreeTags() releases a whole level tag slab by slab.
 
 #include <stddef.h>
 #include <stdalign.h>
@@ -62,6 +68,9 @@ typedef struct memblock_s
 	size_t size; // including the header and blocks
 	size_t realsize; // size of real data only
 
+	struct zslab_s *slab; // slab this block was carved from, NULL if malloc'd
+	boolean pinned; // slab block moved to the main list by Z_ChangeTag
+
 #ifdef ZDEBUG
 	const char *ownerfile;
 	INT32 ownerline;
@@ -77,6 +86,63 @@ typedef struct memblock_s
 // both the head and tail of the zone memory block list
 static memblock_t head;
 
+// -------------------
+// Level slab pools
+// -------------------
+
+// Size classes handed out by the slabs, in bytes of user data.
+// Multiples of 16 so every slot stays aligned to max_align_t.
+static const size_t slabclasssizes[] =
+{
+	  32,   48,   64,   80,   96,  112,  128,
+	 160,  192,  224,  256,
+	 320,  384,  448,  512,
+	 640,  768,  896, 1024
+};
+
+#define NUMSLABCLASSES (sizeof slabclasssizes / sizeof *slabclasssizes)
+#define SLABMAXSIZE 1024
+#define SLABBYTES (64<<10) // rough size of one slab, header excluded
+
+#define SLABFIRSTTAG PU_LEVEL
+#define NUMSLABPOOLS (PU_PURGELEVEL - PU_LEVEL)
+
+struct zslabpool_s;
+
+typedef struct zslab_s
+{
+	struct zslab_s *next;
+	struct zslabpool_s *pool; // NULL once orphaned by Z_FreeTags
+	size_t stride; // header + padding + class size
+	size_t numslots;
+	UINT32 pinned; // blocks that were moved to the main list
+} zslab_t;
+
+#define SLABHEADER ((sizeof (zslab_t) + (alignof (max_align_t) - 1)) & ~(alignof (max_align_t) - 1))
+#define SLABDATA(s) ((UINT8 *)(s) + SLABHEADER)
+
+typedef struct
+{
+	zslab_t *slabs; // every slab of this class
+	memblock_t *freelist; // freed slots, chained through next
+	UINT8 *carve, *carveend; // untouched slots of the newest slab
+} zslabclass_t;
+
+typedef struct zslabpool_s
+{
+	INT32 tag;
+	zslabclass_t classes[NUMSLABCLASSES];
+	memblock_t live; // head and tail of the live blocks in this pool
+	size_t usage; // same accounting as Z_TagsUsage
+	size_t numslabs;
+	size_t numusers; // live blocks with a user pointer to clear
+} zslabpool_t;
+
+static zslabpool_t slabpools[NUMSLABPOOLS];
+
+// size class for every 16 byte step up to SLABMAXSIZE
+static UINT8 slabclassforsize[(SLABMAXSIZE>>4) + 1];
+
 //
 // Function prototypes
 //
@@ -98,10 +164,26 @@ void Z_Init(void)
 {
 	size_t total, memfree;
 
+	size_t i, c;
+
 	memset(&head, 0x00, sizeof(head));
 
 	head.next = head.prev = &head;
 
+	memset(slabpools, 0x00, sizeof(slabpools));
+	for (i = 0; i < NUMSLABPOOLS; i++)
+	{
+		slabpools[i].tag = SLABFIRSTTAG + (INT32)i;
+		slabpools[i].live.next = slabpools[i].live.prev = &slabpools[i].live;
+	}
+
+	for (i = 0, c = 0; i < sizeof slabclassforsize; i++)
+	{
+		while (slabclasssizes[c] < (i<<4))
+			c++;
+		slabclassforsize[i] = (UINT8)c;
+	}
+
 	memfree = I_GetFreeMem(&total)>>20;
 	CONS_Printf("System memory: %sMB - Free: %sMB\n", sizeu1(total>>20), sizeu2(memfree));
 
@@ -118,6 +200,244 @@ void Z_Init(void)
 // Zone memory allocation
 // ----------------------
 
+/** malloc() that doesn't accept failure.
+  *
+  * \param size Amount of memory to be allocated, in bytes.
+  * \return A pointer to the allocated memory.
+  */
+static void *xm(size_t size)
+{
+	const size_t padedsize = size+sizeof (size_t);
+	void *p;
+
+	if (padedsize < size)/* overflow check */
+		I_Error("You are allocating memory too large!");
+	p = malloc(padedsize);
+
+	if (p == NULL)
+	{
+		// Oh crumbs: we're out of heap. Try purging the cache and reallocating.
+		Z_FreeTags(PU_PURGELEVEL, INT32_MAX);
+		p = malloc(padedsize);
+
+		if (p == NULL)
+		{
+			I_Error("Out of memory allocating %s bytes", sizeu1(size));
+		}
+	}
+
+	return p;
+}
+
+/** Returns the slab pool serving a tag and size, if any.
+  *
+  * \param size Amount of memory to be allocated, in bytes.
+  * \param tag Purge tag.
+  * \return The pool to allocate from, or NULL to use malloc().
+  */
+static inline zslabpool_t *Z_SlabPoolFor(size_t size, INT32 tag)
+{
+	if (tag < SLABFIRSTTAG || tag >= SLABFIRSTTAG + NUMSLABPOOLS)
+		return NULL;
+	if (size > SLABMAXSIZE)
+		return NULL;
+	return &slabpools[tag - SLABFIRSTTAG];
+}
+
+/** Takes a slot from a slab pool, adding a new slab when needed.
+  * The block is linked into the pool's live list, the caller fills in the rest.
+  *
+  * \param pool The pool to allocate from.
+  * \param size Amount of memory to be allocated, in bytes.
+  * \return The block header of the slot.
+  */
+static memblock_t *Z_SlabAlloc(zslabpool_t *pool, size_t size)
+{
+	zslabclass_t *cls = &pool->classes[slabclassforsize[(size + 15)>>4]];
+	memblock_t *block;
+
+	if (cls->freelist)
+	{
+		block = cls->freelist;
+		cls->freelist = block->next;
+	}
+	else
+	{
+		if (cls->carve == cls->carveend)
+		{
+			const size_t stride = sizeof (memblock_t) + ALIGNPAD + slabclasssizes[cls - pool->classes];
+			const size_t numslots = max(SLABBYTES / stride, 1);
+			zslab_t *slab = xm(SLABHEADER + numslots * stride);
+
+			slab->pool = pool;
+			slab->stride = stride;
+			slab->numslots = numslots;
+			slab->pinned = 0;
+			slab->next = cls->slabs;
+			cls->slabs = slab;
+			pool->numslabs++;
+
+			cls->carve = SLABDATA(slab);
+			cls->carveend = cls->carve + numslots * stride;
+		}
+
+		block = (memblock_t *)cls->carve;
+		block->slab = cls->slabs;
+		cls->carve += cls->slabs->stride;
+	}
+
+	block->pinned = false;
+
+	block->next = pool->live.next;
+	block->prev = &pool->live;
+	pool->live.next = block;
+	block->next->prev = block;
+
+	return block;
+}
+
+/** Returns a slab block to its pool. It must already be unlinked.
+  *
+  * \param block The block header of the slot.
+  */
+static void Z_SlabFree(memblock_t *block)
+{
+	zslab_t *slab = block->slab;
+	zslabpool_t *pool = slab->pool;
+	zslabclass_t *cls;
+
+	block->id = 0;
+
+	if (block->pinned)
+	{
+		slab->pinned--;
+
+		// The rest of an orphaned slab is already dead
+		if (pool == NULL)
+		{
+			if (slab->pinned == 0)
+				free(slab);
+			return;
+		}
+	}
+	else
+	{
+		pool->usage -= block->size + sizeof *block;
+		if (block->user != NULL)
+			pool->numusers--;
+	}
+
+	cls = &pool->classes[slabclassforsize[(slab->stride - sizeof (memblock_t) - ALIGNPAD)>>4]];
+	block->next = cls->freelist;
+	cls->freelist = block;
+}
+
+/** Moves a slab block out of its pool's live list and into the main list,
+  * so that it can change tags without being freed along with the pool.
+  *
+  * \param block The block header of the slot.
+  */
+static void Z_SlabPin(memblock_t *block)
+{
+	zslabpool_t *pool = block->slab->pool;
+
+	pool->usage -= block->size + sizeof *block;
+	if (block->user != NULL)
+		pool->numusers--;
+
+	block->prev->next = block->next;
+	block->next->prev = block->prev;
+
+	block->next = head.next;
+	block->prev = &head;
+	head.next = block;
+	block->next->prev = block;
+
+	block->pinned = true;
+	block->slab->pinned++;
+}
+
+// pool Z_SlabOwnsDeadPointer checks against
+static zslabpool_t *freeingpool;
+
+/** Checks whether a pointer lies within a live, unpinned slot of the
+  * pool that is being freed.
+  *
+  * \param ptr The pointer to check.
+  * \return true if the memory behind the pointer is about to be freed.
+  */
+static boolean Z_SlabOwnsDeadPointer(void *ptr)
+{
+	const UINT8 *p = ptr;
+	size_t c;
+
+	for (c = 0; c < NUMSLABCLASSES; c++)
+	{
+		zslab_t *slab;
+
+		for (slab = freeingpool->classes[c].slabs; slab; slab = slab->next)
+		{
+			const UINT8 *data = SLABDATA(slab);
+
+			if (p >= data && p < data + slab->numslots * slab->stride)
+			{
+				const memblock_t *block = (const memblock_t *)(data + ((size_t)(p - data) / slab->stride) * slab->stride);
+				return (block->id == ZONEID && !block->pinned);
+			}
+		}
+	}
+
+	return false;
+}
+
+/** Frees every block of a slab pool at once.
+  * Pinned blocks keep their slab alive until they are freed themselves.
+  *
+  * \param pool The pool to free.
+  */
+static void Z_FreeSlabPool(zslabpool_t *pool)
+{
+	memblock_t *block;
+	size_t c;
+
+	if (pool->numslabs == 0)
+		return;
+
+	// Keep the Z_Free promises for every block, without visiting each one
+	freeingpool = pool;
+	LUA_InvalidateUserdataIf(Z_SlabOwnsDeadPointer);
+	freeingpool = NULL;
+
+	if (pool->numusers)
+	{
+		for (block = pool->live.next; block != &pool->live; block = block->next)
+			if (block->user != NULL)
+				*block->user = NULL;
+	}
+
+	for (c = 0; c < NUMSLABCLASSES; c++)
+	{
+		zslabclass_t *cls = &pool->classes[c];
+		zslab_t *slab, *next;
+
+		for (slab = cls->slabs; slab; slab = next)
+		{
+			next = slab->next;
+			if (slab->pinned)
+				slab->pool = NULL;
+			else
+				free(slab);
+		}
+
+		memset(cls, 0x00, sizeof *cls);
+	}
+
+	pool->live.next = pool->live.prev = &pool->live;
+	pool->usage = 0;
+	pool->numslabs = 0;
+	pool->numusers = 0;
+}
+
 /** Frees allocated memory.
   *
   * \param ptr A pointer to allocated memory,
@@ -165,41 +485,19 @@ void Z_Free(void *ptr)
 	if (block->user != NULL)
 		*block->user = NULL;
 
-#ifdef VALGRIND_DESTROY_MEMPOOL
-	VALGRIND_DESTROY_MEMPOOL(block);
-#endif
 	block->prev->next = block->next;
 	block->next->prev = block->prev;
-	free(block);
-}
 
-/** malloc() that doesn't accept failure.
-  *
-  * \param size Amount of memory to be allocated, in bytes.
-  * \return A pointer to the allocated memory.
-  */
-static void *xm(size_t size)
-{
-	const size_t padedsize = size+sizeof (size_t);
-	void *p;
-
-	if (padedsize < size)/* overflow check */
-		I_Error("You are allocating memory too large!");
-	p = malloc(padedsize);
-
-	if (p == NULL)
+	if (block->slab)
 	{
-		// Oh crumbs: we're out of heap. Try purging the cache and reallocating.
-		Z_FreeTags(PU_PURGELEVEL, INT32_MAX);
-		p = malloc(padedsize);
-
-		if (p == NULL)
-		{
-			I_Error("Out of memory allocating %s bytes", sizeu1(size));
-		}
+		Z_SlabFree(block);
+		return;
 	}
 
-	return p;
+#ifdef VALGRIND_DESTROY_MEMPOOL
+	VALGRIND_DESTROY_MEMPOOL(block);
+#endif
+	free(block);
 }
 
 /** The Z_MallocAlign function.
@@ -221,6 +519,7 @@ void *Z_Malloc2(size_t size, INT32 tag, void *user, INT32 alignbits,
 void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 #endif
 {
+	zslabpool_t *pool = Z_SlabPoolFor(size, tag);
 	memblock_t *block;
 	void *ptr;
 
@@ -230,7 +529,20 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	CONS_Debug(DBG_MEMORY, "Z_Malloc %s:%d\n", file, line);
 #endif
 
-	block = xm(sizeof (memblock_t) + ALIGNPAD + size);
+	if (pool)
+		block = Z_SlabAlloc(pool, size);
+	else
+	{
+		block = xm(sizeof (memblock_t) + ALIGNPAD + size);
+
+		block->next = head.next;
+		block->prev = &head;
+		head.next = block;
+		block->next->prev = block;
+
+		block->slab = NULL;
+		block->pinned = false;
+	}
 	ptr = MEMORY(block);
 	I_Assert((intptr_t)ptr % alignof (max_align_t) == 0);
 
@@ -238,11 +550,6 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	Z_calloc = false;
 #endif
 
-	block->next = head.next;
-	block->prev = &head;
-	head.next = block;
-	block->next->prev = block;
-
 	block->tag = tag;
 	block->user = NULL;
 #ifdef ZDEBUG
@@ -253,15 +560,21 @@ void *Z_MallocAlign(size_t size, INT32 tag, void *user, INT32 alignbits)
 	block->realsize = size;
 
 #ifdef VALGRIND_CREATE_MEMPOOL
-	VALGRIND_CREATE_MEMPOOL(block, size, Z_calloc);
+	if (!pool)
+		VALGRIND_CREATE_MEMPOOL(block, size, Z_calloc);
 #endif
 
 	block->id = ZONEID;
 
+	if (pool)
+		pool->usage += block->size + sizeof *block;
+
 	if (user != NULL)
 	{
 		block->user = user;
 		*(void **)user = ptr;
+		if (pool)
+			pool->numusers++;
 	}
 	else if (tag >= PU_PURGELEVEL)
 		I_Error("Z_Malloc: attempted to allocate purgable block "
@@ -397,8 +710,13 @@ void *Z_ReallocAlign(void *ptr, size_t size, INT32 tag, void *user, INT32 alignb
 void Z_FreeTags(INT32 lowtag, INT32 hightag)
 {
 	memblock_t *block, *next;
+	INT32 i;
 
 	Z_CheckHeap(420);
+
+	for (i = max(lowtag, SLABFIRSTTAG); i <= hightag && i < SLABFIRSTTAG + NUMSLABPOOLS; i++)
+		Z_FreeSlabPool(&slabpools[i - SLABFIRSTTAG]);
+
 	for (block = head.next; block != &head; block = next)
 	{
 		next = block->next; // get link before freeing
@@ -416,10 +734,24 @@ void Z_FreeTags(INT32 lowtag, INT32 hightag)
 void Z_IterateTags(INT32 lowtag, INT32 hightag, boolean (*iterfunc)(void *))
 {
 	memblock_t *block, *next;
+	INT32 i;
 
 	if (!iterfunc)
 		I_Error("Z_IterateTags: no iterator function was given");
 
+	for (i = max(lowtag, SLABFIRSTTAG); i <= hightag && i < SLABFIRSTTAG + NUMSLABPOOLS; i++)
+	{
+		memblock_t *live = &slabpools[i - SLABFIRSTTAG].live;
+
+		for (block = live->next; block != live; block = next)
+		{
+			void *mem = MEMORY(block);
+			next = block->next; // get link before possibly freeing
+			if (iterfunc(mem))
+				Z_Free(mem);
+		}
+	}
+
 	for (block = head.next; block != &head; block = next)
 	{
 		next = block->next; // get link before possibly freeing
@@ -463,33 +795,32 @@ void Z_CheckMemCleanup(void)
 }
 
 
-/** Checks the heap, as well as the memhdr_ts, for any corruption or
-  * other problems.
+/** Checks one list of memhdr_ts for any corruption or other problems.
+  * \param list Head and tail of the list to check.
   * \param i Identifies from where in the code Z_CheckHeap was called.
-  * \author Graue <graue@oceanbase.org>
+  * \param blocknumon Running count of blocks checked, for error messages.
   */
-void Z_CheckHeap(INT32 i)
+static void Z_CheckBlockList(memblock_t *list, INT32 i, UINT32 *blocknumon)
 {
 	memblock_t *block;
-	UINT32 blocknumon = 0;
 	void *given;
 
-	for (block = head.next; block != &head; block = block->next)
+	for (block = list->next; block != list; block = block->next)
 	{
-		blocknumon++;
+		(*blocknumon)++;
 		given = MEMORY(block);
 #ifdef ZDEBUG2
 		CONS_Debug(DBG_MEMORY, "block %u owned by %s:%d\n",
 			blocknumon, block->ownerfile, block->ownerline);
 #endif
 #ifdef VALGRIND_MEMPOOL_EXISTS
-		if (!VALGRIND_MEMPOOL_EXISTS(block))
+		if (!block->slab && !VALGRIND_MEMPOOL_EXISTS(block))
 		{
 			I_Error("Z_CheckHeap %d: block %u"
 #ifdef ZDEBUG
 				"(owned by %s:%d)"
 #endif
-				" should not exist", i, blocknumon
+				" should not exist", i, *blocknumon
 #ifdef ZDEBUG
 				, block->ownerfile, block->ownerline
 #endif
@@ -502,7 +833,7 @@ void Z_CheckHeap(INT32 i)
 #ifdef ZDEBUG
 				"(owned by %s:%d)"
 #endif
-				" doesn't have a proper user", i, blocknumon
+				" doesn't have a proper user", i, *blocknumon
 #ifdef ZDEBUG
 				, block->ownerfile, block->ownerline
 #endif
@@ -514,7 +845,7 @@ void Z_CheckHeap(INT32 i)
 #ifdef ZDEBUG
 				"(owned by %s:%d)"
 #endif
-				" lacks proper backlink", i, blocknumon
+				" lacks proper backlink", i, *blocknumon
 #ifdef ZDEBUG
 				, block->ownerfile, block->ownerline
 #endif
@@ -526,7 +857,7 @@ void Z_CheckHeap(INT32 i)
 #ifdef ZDEBUG
 				"(owned by %s:%d)"
 #endif
-				" lacks proper forward link", i, blocknumon
+				" lacks proper forward link", i, *blocknumon
 #ifdef ZDEBUG
 				, block->ownerfile, block->ownerline
 #endif
@@ -538,7 +869,7 @@ void Z_CheckHeap(INT32 i)
 #ifdef ZDEBUG
 				"(owned by %s:%d)"
 #endif
-				" have the wrong ID", i, blocknumon
+				" have the wrong ID", i, *blocknumon
 #ifdef ZDEBUG
 				, block->ownerfile, block->ownerline
 #endif
@@ -547,6 +878,21 @@ void Z_CheckHeap(INT32 i)
 	}
 }
 
+/** Checks the heap, as well as the memhdr_ts, for any corruption or
+  * other problems.
+  * \param i Identifies from where in the code Z_CheckHeap was called.
+  * \author Graue <graue@oceanbase.org>
+  */
+void Z_CheckHeap(INT32 i)
+{
+	UINT32 blocknumon = 0;
+	size_t p;
+
+	Z_CheckBlockList(&head, i, &blocknumon);
+	for (p = 0; p < NUMSLABPOOLS; p++)
+		Z_CheckBlockList(&slabpools[p].live, i, &blocknumon);
+}
+
 // ------------------------
 // Zone memory modification
 // ------------------------
@@ -582,6 +928,10 @@ void Z_ChangeTag(void *ptr, INT32 tag)
 	// No, please, don't make my PU_STATIC patch NULL! It supposed to be always valid!
 	if (block->tag < 10) return;
 
+	// The slab it sits in is freed along with its old tag
+	if (block->slab && !block->pinned && tag != block->tag)
+		Z_SlabPin(block);
+
 	block->tag = tag;
 }
 
@@ -613,6 +963,14 @@ void Z_SetUser(void *ptr, void **newuser)
 		I_Error("Internal memory management error: "
 			"tried to make block purgable but it has no owner");
 
+	if (block->slab && !block->pinned)
+	{
+		if (block->user == NULL && newuser != NULL)
+			block->slab->pool->numusers++;
+		else if (block->user != NULL && newuser == NULL)
+			block->slab->pool->numusers--;
+	}
+
 	block->user = (void*)newuser;
 	*newuser = ptr;
 }
@@ -632,6 +990,10 @@ size_t Z_TagsUsage(INT32 lowtag, INT32 hightag)
 {
 	size_t cnt = 0;
 	memblock_t *rover;
+	INT32 i;
+
+	for (i = max(lowtag, SLABFIRSTTAG); i <= hightag && i < SLABFIRSTTAG + NUMSLABPOOLS; i++)
+		cnt += slabpools[i - SLABFIRSTTAG].usage;
 
 	for (rover = head.next; rover != &head; rover = rover->next)
 	{
@@ -649,16 +1011,19 @@ size_t Z_TagsUsage(INT32 lowtag, INT32 hightag)
 
 /** The function called by the "memfree" console command.
   * Prints the memory being used by each part of the game to the console.
+  * "memfree lua" also lists the size classes of the Lua memory pool.
   */
 static void Command_Memfree_f(void)
 {
 	size_t freebytes, totalbytes;
+	size_t numslabs = 0, slabbytes = 0;
+	size_t p, c;
 
 	Z_CheckHeap(-1);
 	CONS_Printf("\x82%s", M_GetText("Memory Info\n"));
-	CONS_Printf(M_GetText("Total heap used   : %7s KB\n"), sizeu1(Z_TagsUsage(0, INT32_MAX)>>10));
+	CONS_Printf(M_GetText("Total heap used   : %7s KB\n"), sizeu1((Z_TagsUsage(0, INT32_MAX) + LUA_MemoryUsage())>>10));
 	CONS_Printf(M_GetText("Static            : %7s KB\n"), sizeu1(Z_TagUsage(PU_STATIC)>>10));
-	CONS_Printf(M_GetText("Lua               : %7s KB\n"), sizeu1(Z_TagUsage(PU_LUA)>>10));
+	CONS_Printf(M_GetText("Lua               : %7s KB\n"), sizeu1((Z_TagUsage(PU_LUA) + LUA_MemoryUsage())>>10));
 	CONS_Printf(M_GetText("Static (sound)    : %7s KB\n"), sizeu1(Z_TagUsage(PU_SOUND)>>10));
 	CONS_Printf(M_GetText("Static (music)    : %7s KB\n"), sizeu1(Z_TagUsage(PU_MUSIC)>>10));
 	CONS_Printf(M_GetText("Locked cache      : %7s KB\n"), sizeu1(Z_TagUsage(PU_CACHE)>>10));
@@ -667,6 +1032,19 @@ static void Command_Memfree_f(void)
 	CONS_Printf(M_GetText("All purgable      : %7s KB\n"),
 		sizeu1(Z_TagsUsage(PU_PURGELEVEL, INT32_MAX)>>10));
 
+	for (p = 0; p < NUMSLABPOOLS; p++)
+		for (c = 0; c < NUMSLABCLASSES; c++)
+		{
+			zslab_t *slab;
+			for (slab = slabpools[p].classes[c].slabs; slab; slab = slab->next)
+			{
+				numslabs++;
+				slabbytes += SLABHEADER + slab->numslots * slab->stride;
+			}
+		}
+	CONS_Printf(M_GetText("Level slabs       : %7s KB (%s slabs)\n"), sizeu1(slabbytes>>10), sizeu2(numslabs));
+	LUA_PrintMemoryStats(COM_Argc() > 1 && !stricmp(COM_Argv(1), "lua"));
+
 #ifdef HWRENDER
 	if (rendermode != render_soft && rendermode != render_none)
 	{
@@ -697,6 +1075,7 @@ static void Command_Memdump_f(void)
 	memblock_t *block;
 	INT32 mintag = 0, maxtag = INT32_MAX;
 	INT32 i;
+	size_t p;
 
 	if ((i = COM_CheckParm("-min")))
 		mintag = atoi(COM_Argv(i + 1));
@@ -710,6 +1089,14 @@ static void Command_Memdump_f(void)
 			char *filename = strrchr(block->ownerfile, PATHSEP[0]);
 			CONS_Printf("[%3d] %s (%s) bytes @ %s:%d\n", block->tag, sizeu1(block->size), sizeu2(block->realsize), filename ? filename + 1 : block->ownerfile, block->ownerline);
 		}
+
+	for (p = 0; p < NUMSLABPOOLS; p++)
+		for (block = slabpools[p].live.next; block != &slabpools[p].live; block = block->next)
+			if (block->tag >= mintag && block->tag <= maxtag)
+			{
+				char *filename = strrchr(block->ownerfile, PATHSEP[0]);
+				CONS_Printf("[%3d] %s (%s) bytes @ %s:%d (slab)\n", block->tag, sizeu1(block->size), sizeu2(block->realsize), filename ? filename + 1 : block->ownerfile, block->ownerline);
+			}
 }
 #endif
 